@@ -14,6 +14,9 @@
 #include <QIcon>
 
 #include "export.hpp"
+#include "compat/sample-event.hpp"
+
+#include <cstdint>
 
 #ifndef OPENTRACK_PLUGIN_EXPORT
 #   ifdef _WIN32
@@ -32,6 +35,20 @@ enum Axis {
     TX, TY, TZ, Yaw, Pitch, Roll
 };
 
+// bumped when virtual members are appended to the plugin interfaces.
+// plugins built against another version aren't loaded.
+// 2: ITracker::data_ex, IFilter::filter_ex
+#define OPENTRACK_PLUGIN_API_VERSION 2
+
+// what's known about the sample the pipeline is processing
+struct sample_info
+{
+    // capture time in seconds, on the Timer::monotonic_seconds() clock
+    double timestamp;
+    // increases with every new sample, even if the pose didn't change
+    std::uint64_t seq;
+};
+
 namespace plugin_api {
 namespace detail {
 
@@ -51,6 +68,7 @@ signals:
     extern "C" OPENTRACK_PLUGIN_EXPORT ctor_ret_class* GetConstructor(); \
     extern "C" OPENTRACK_PLUGIN_EXPORT Metadata* GetMetadata(); \
     extern "C" OPENTRACK_PLUGIN_EXPORT dialog_ret_class* GetDialog(); \
+    extern "C" OPENTRACK_PLUGIN_EXPORT int GetPluginApiVersion(); \
     \
     extern "C" OPENTRACK_PLUGIN_EXPORT ctor_ret_class* GetConstructor() \
     { \
@@ -63,6 +81,10 @@ signals:
     extern "C" OPENTRACK_PLUGIN_EXPORT dialog_ret_class* GetDialog() \
     { \
         return new dialog_class; \
+    } \
+    extern "C" OPENTRACK_PLUGIN_EXPORT int GetPluginApiVersion() \
+    { \
+        return OPENTRACK_PLUGIN_API_VERSION; \
     }
 
 // implement this in all plugins
@@ -97,6 +119,9 @@ struct OPENTRACK_API_EXPORT IFilter
     virtual void filter(const double *input, double *output) = 0;
     // optionally reset the filter when centering
     virtual void center() {}
+    // optional, filter() with the sample's capture time and sequence number.
+    // use these rather than a timer and comparing inputs to tell new samples from repeated ones.
+    virtual void filter_ex(const double *input, double *output, const sample_info&) { filter(input, output); }
 };
 
 struct OPENTRACK_API_EXPORT IFilterDialog : public plugin_api::detail::BaseDialog
@@ -163,6 +188,20 @@ struct OPENTRACK_API_EXPORT ITracker
     // tracker notified of centering
     // returning true makes identity the center pose
     virtual bool center() { return false; }
+    // optionally return true if you call notify_new_data() every time data() has a new sample.
+    // the pipeline then wakes up on new samples rather than polling data() on a fixed period.
+    virtual bool is_event_driven() { return false; }
+    // optional, data() that also reports when the sample was captured.
+    // return false if not implemented, the pipeline then calls data() and
+    // makes up the timestamp and sequence number itself.
+    virtual bool data_ex(double *data, sample_info& info) { (void) data; (void) info; return false; }
+
+    // call from the tracker's own thread once the new sample is visible to data()
+    void notify_new_data() { new_data.notify(); }
+    // pipeline-only. returns false if no new sample arrived before the timeout
+    bool wait_for_new_data(unsigned msecs) { return new_data.wait(msecs); }
+private:
+    sample_event new_data;
 };
 
 struct OPENTRACK_API_EXPORT ITrackerDialog : public plugin_api::detail::BaseDialog
@@ -46,6 +46,7 @@
 
 extern "C" typedef void* (*OPENTRACK_CTOR_FUNPTR)(void);
 extern "C" typedef Metadata* (*OPENTRACK_METADATA_FUNPTR)(void);
+extern "C" typedef int (*OPENTRACK_API_VERSION_FUNPTR)(void);
 
 struct dylib final {
     enum Type { Filter, Tracker, Protocol };
@@ -81,6 +82,17 @@ struct dylib final {
         if (_foo::die(handle, !handle->load()))
             return;
 
+        // older plugins lack the newer virtual members, calling those crashes
+        const auto api_version = (OPENTRACK_API_VERSION_FUNPTR) handle->resolve("GetPluginApiVersion");
+        if (!api_version || api_version() != OPENTRACK_PLUGIN_API_VERSION)
+        {
+            qDebug() << "plugin API version mismatch" << filename
+                     << (api_version ? api_version() : 1) << "!=" << OPENTRACK_PLUGIN_API_VERSION;
+            delete handle;
+            handle = nullptr;
+            return;
+        }
+
         Dialog = (OPENTRACK_CTOR_FUNPTR) handle->resolve("GetDialog");
         if (_foo::die(handle, !Dialog))
             return;
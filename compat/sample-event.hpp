@@ -0,0 +1,49 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// wakes up a single waiter each time a producer has something new.
+// notifications between two waits coalesce and never get lost.
+
+class sample_event final
+{
+    std::mutex mtx;
+    std::condition_variable cvar;
+    unsigned seq, last_seq;
+
+public:
+    sample_event() : seq(0), last_seq(0) {}
+
+    sample_event(const sample_event&) = delete;
+    sample_event& operator=(const sample_event&) = delete;
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> l(mtx);
+            seq++;
+        }
+        cvar.notify_one();
+    }
+
+    // returns false on timeout
+    bool wait(unsigned msecs)
+    {
+        std::unique_lock<std::mutex> l(mtx);
+        const bool ret = cvar.wait_for(l,
+                                       std::chrono::milliseconds(msecs),
+                                       [this]() { return seq != last_seq; });
+        last_seq = seq;
+        return ret;
+    }
+};
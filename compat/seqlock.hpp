@@ -0,0 +1,77 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// single writer, any number of readers. the writer never waits,
+// readers retry in the rare case they overlapped with a store.
+// the payload lives in relaxed atomic words so that torn reads
+// are detected rather than being undefined behavior.
+
+template<typename t>
+class seqlock final
+{
+    static_assert(std::is_trivially_copyable<t>::value, "seqlock payload must be trivially copyable");
+
+    using word = std::uintptr_t;
+    static constexpr unsigned nwords = (sizeof(t) + sizeof(word) - 1) / sizeof(word);
+
+    std::atomic<unsigned> seq;
+    std::atomic<word> data[nwords];
+
+public:
+    seqlock() : seq(0u)
+    {
+        for (unsigned i = 0; i < nwords; i++)
+            data[i].store(0, std::memory_order_relaxed);
+    }
+
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    void store(const t& val)
+    {
+        word tmp[nwords] = {};
+        std::memcpy(tmp, &val, sizeof(t));
+
+        const unsigned s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (unsigned i = 0; i < nwords; i++)
+            data[i].store(tmp[i], std::memory_order_relaxed);
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    t load() const
+    {
+        word tmp[nwords];
+        unsigned s1, s2;
+
+        do
+        {
+            s1 = seq.load(std::memory_order_acquire);
+
+            for (unsigned i = 0; i < nwords; i++)
+                tmp[i] = data[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s2 = seq.load(std::memory_order_relaxed);
+        } while ((s1 & 1u) || s1 != s2);
+
+        t ret;
+        std::memcpy(&ret, tmp, sizeof(t));
+        return ret;
+    }
+};
@@ -97,4 +97,11 @@ public:
     {
         return double(elapsed_nsecs() * 1e-9L);
     }
+    // shared time base for timestamps passed between modules
+    static double monotonic_seconds()
+    {
+        struct timespec cur;
+        clock_gettime(CLOCK_MONOTONIC, &cur);
+        return double(cur.tv_sec) + double(cur.tv_nsec) * 1e-9;
+    }
 };
@@ -0,0 +1,307 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#ifdef __linux
+
+#include "v4l2-capture.hpp"
+#include "compat/timer.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+#include <QDebug>
+
+v4l2_capture::v4l2_capture() :
+    fd(-1), fourcc(0), w(0), h(0), stride(0), fps_(0)
+{
+}
+
+v4l2_capture::~v4l2_capture()
+{
+    close();
+}
+
+int v4l2_capture::xioctl(unsigned long request, void* arg)
+{
+    int ret;
+    do
+        ret = ioctl(fd, request, arg);
+    while (ret == -1 && errno == EINTR);
+    return ret;
+}
+
+const char* v4l2_capture::format_name() const
+{
+    switch (fourcc)
+    {
+    case V4L2_PIX_FMT_GREY: return "GREY";
+    case V4L2_PIX_FMT_YUYV: return "YUYV";
+    case V4L2_PIX_FMT_UYVY: return "UYVY";
+    default: return "none";
+    }
+}
+
+bool v4l2_capture::set_format(int width, int height)
+{
+    // in order of preference, GREY needs no conversion at all
+    static const unsigned formats[] = { V4L2_PIX_FMT_GREY, V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_UYVY };
+
+    for (unsigned f : formats)
+    {
+        v4l2_format fmt;
+        std::memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = unsigned(width);
+        fmt.fmt.pix.height = unsigned(height);
+        fmt.fmt.pix.pixelformat = f;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+
+        // drivers substitute a format they have if they don't have this one
+        if (xioctl(VIDIOC_S_FMT, &fmt) == -1 || fmt.fmt.pix.pixelformat != f)
+            continue;
+
+        fourcc = f;
+        w = int(fmt.fmt.pix.width);
+        h = int(fmt.fmt.pix.height);
+        stride = int(fmt.fmt.pix.bytesperline);
+        if (stride == 0)
+            stride = f == V4L2_PIX_FMT_GREY ? w : w * 2;
+        return true;
+    }
+
+    return false;
+}
+
+void v4l2_capture::set_fps(int fps)
+{
+    v4l2_streamparm parm;
+    std::memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+
+    fps_ = 0;
+
+    if (fps > 0)
+    {
+        parm.parm.capture.timeperframe.numerator = 1;
+        parm.parm.capture.timeperframe.denominator = unsigned(fps);
+        if (xioctl(VIDIOC_S_PARM, &parm) == -1)
+            qDebug() << "v4l2: can't set fps" << errno;
+    }
+
+    if (xioctl(VIDIOC_G_PARM, &parm) == 0 && parm.parm.capture.timeperframe.numerator != 0)
+        fps_ = int(parm.parm.capture.timeperframe.denominator / parm.parm.capture.timeperframe.numerator);
+}
+
+bool v4l2_capture::map_buffers(unsigned count)
+{
+    v4l2_requestbuffers req;
+    std::memset(&req, 0, sizeof(req));
+    req.count = count;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+
+    if (xioctl(VIDIOC_REQBUFS, &req) == -1 || req.count < 2)
+    {
+        qDebug() << "v4l2: can't get buffers" << errno;
+        return false;
+    }
+
+    for (unsigned i = 0; i < req.count; i++)
+    {
+        v4l2_buffer buf;
+        std::memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+
+        if (xioctl(VIDIOC_QUERYBUF, &buf) == -1)
+            return false;
+
+        void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buf.m.offset);
+
+        if (start == MAP_FAILED)
+        {
+            qDebug() << "v4l2: mmap failed" << errno;
+            return false;
+        }
+
+        buffers.push_back(buffer { start, buf.length });
+
+        if (xioctl(VIDIOC_QBUF, &buf) == -1)
+            return false;
+    }
+
+    return true;
+}
+
+void v4l2_capture::unmap_buffers()
+{
+    for (const buffer& b : buffers)
+        munmap(b.start, b.length);
+    buffers.clear();
+}
+
+bool v4l2_capture::open(int index, int width, int height, int fps, unsigned nbuffers)
+{
+    close();
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "/dev/video%d", index);
+
+    fd = ::open(name, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        qDebug() << "v4l2: can't open" << name << errno;
+        return false;
+    }
+
+    v4l2_capability cap;
+    std::memset(&cap, 0, sizeof(cap));
+
+    if (xioctl(VIDIOC_QUERYCAP, &cap) == -1 ||
+        !(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) ||
+        !(cap.capabilities & V4L2_CAP_STREAMING))
+    {
+        qDebug() << "v4l2:" << name << "can't stream video";
+        close();
+        return false;
+    }
+
+    if (!set_format(width, height))
+    {
+        qDebug() << "v4l2:" << name << "has no grayscale or yuv 4:2:2 format";
+        close();
+        return false;
+    }
+
+    set_fps(fps);
+
+    if (!map_buffers(nbuffers))
+    {
+        close();
+        return false;
+    }
+
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMON, &type) == -1)
+    {
+        qDebug() << "v4l2: can't start streaming" << errno;
+        close();
+        return false;
+    }
+
+    qDebug() << "v4l2:" << name << w << "x" << h << "@" << fps_ << format_name() << buffers.size() << "buffers";
+
+    return true;
+}
+
+void v4l2_capture::close()
+{
+    if (fd == -1)
+        return;
+
+    int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    (void) xioctl(VIDIOC_STREAMOFF, &type);
+
+    unmap_buffers();
+
+    // give the buffers back to the driver
+    v4l2_requestbuffers req;
+    std::memset(&req, 0, sizeof(req));
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    (void) xioctl(VIDIOC_REQBUFS, &req);
+
+    ::close(fd);
+    fd = -1;
+    fourcc = 0;
+    w = h = stride = fps_ = 0;
+}
+
+void v4l2_capture::copy_luma(const unsigned char* src, cv::Mat& gray) const
+{
+    if (gray.rows != h || gray.cols != w || gray.type() != CV_8UC1)
+        gray.create(h, w, CV_8UC1);
+
+    // every other byte, starting with Y for YUYV and with U for UYVY
+    const int offset = fourcc == V4L2_PIX_FMT_UYVY ? 1 : 0;
+
+    for (int y = 0; y < h; y++, src += stride)
+    {
+        unsigned char* dst = gray.ptr(y);
+
+        if (fourcc == V4L2_PIX_FMT_GREY)
+            std::memcpy(dst, src, std::size_t(w));
+        else
+            for (int x = 0; x < w; x++)
+                dst[x] = src[2 * x + offset];
+    }
+}
+
+bool v4l2_capture::read(cv::Mat& gray, double& timestamp, int timeout_ms)
+{
+    if (fd == -1)
+        return false;
+
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ret;
+    do
+        ret = poll(&pfd, 1, timeout_ms);
+    while (ret == -1 && errno == EINTR);
+
+    if (ret <= 0)
+        return false;
+
+    v4l2_buffer buf, next;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+
+    if (xioctl(VIDIOC_DQBUF, &buf) == -1)
+        return false;
+
+    // anything queued up behind it is newer, hand the older one back
+    for (;;)
+    {
+        next = buf;
+        if (xioctl(VIDIOC_DQBUF, &next) == -1)
+            break;
+        (void) xioctl(VIDIOC_QBUF, &buf);
+        buf = next;
+    }
+
+    const bool ok = buf.index < buffers.size() && !(buf.flags & V4L2_BUF_FLAG_ERROR);
+
+    if (ok)
+    {
+        copy_luma(static_cast<const unsigned char*>(buffers[buf.index].start), gray);
+
+        if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+            timestamp = double(buf.timestamp.tv_sec) + double(buf.timestamp.tv_usec) * 1e-6;
+        else
+            timestamp = Timer::monotonic_seconds();
+    }
+
+    (void) xioctl(VIDIOC_QBUF, &buf);
+
+    return ok;
+}
+
+#endif
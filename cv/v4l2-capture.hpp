@@ -0,0 +1,61 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#ifdef __linux
+
+#include <opencv2/core/core.hpp>
+#include <cstddef>
+#include <vector>
+
+// native video4linux2 capture through the driver's mmap'd buffer queue.
+// only takes formats whose luma plane is the grayscale image already
+// (GREY, YUYV, UYVY), so frames come out as CV_8UC1 without a detour
+// through RGB. cameras offering none of these fail to open, callers
+// should fall back to cv::VideoCapture then.
+class v4l2_capture final
+{
+public:
+    v4l2_capture();
+    ~v4l2_capture();
+
+    // index is N in /dev/videoN, same as cv::VideoCapture's.
+    // width, height and fps are requests, the driver picks what it has.
+    bool open(int index, int width, int height, int fps, unsigned nbuffers = 4);
+    void close();
+    bool is_open() const { return fd != -1; }
+
+    // waits up to timeout_ms for a frame and copies its luma into gray.
+    // frames queued up meanwhile are skipped in favor of the newest.
+    // timestamp is when the driver got the frame, in seconds on the same
+    // clock as Timer::monotonic_seconds().
+    bool read(cv::Mat& gray, double& timestamp, int timeout_ms = 1000);
+
+    const char* format_name() const;
+
+private:
+    struct buffer
+    {
+        void* start;
+        std::size_t length;
+    };
+
+    std::vector<buffer> buffers;
+    int fd;
+    unsigned fourcc;
+    int w, h, stride, fps_;
+
+    int xioctl(unsigned long request, void* arg);
+    bool set_format(int width, int height);
+    void set_fps(int fps);
+    bool map_buffers(unsigned count);
+    void unmap_buffers();
+    void copy_luma(const unsigned char* src, cv::Mat& gray) const;
+};
+
+#endif
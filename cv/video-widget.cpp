@@ -36,6 +36,12 @@ void cv_video_widget::update_image(const cv::Mat& frame)
     }
 }
 
+bool cv_video_widget::wants_frame()
+{
+    QMutexLocker foo(&mtx);
+    return visible && !freshp;
+}
+
 void cv_video_widget::paintEvent(QPaintEvent*)
 {
     QMutexLocker foo(&mtx);
@@ -57,7 +63,10 @@ void cv_video_widget::update_and_repaint()
     {
         if (_frame.empty() || !freshp)
             return;
-        cv::cvtColor(_frame, _frame2, cv::COLOR_RGB2BGR);
+        if (_frame.channels() == 1)
+            cv::cvtColor(_frame, _frame2, cv::COLOR_GRAY2RGB);
+        else
+            cv::cvtColor(_frame, _frame2, cv::COLOR_RGB2BGR);
 
         if (_frame3.cols != width() || _frame3.rows != height())
             _frame3 = cv::Mat(height(), width(), CV_8U);
@@ -26,6 +26,9 @@ class cv_video_widget final : public QWidget
 public:
     cv_video_widget(QWidget *parent);
     void update_image(const cv::Mat &frame);
+    // whether update_image() would take a frame now, so that
+    // trackers can skip drawing frames nobody sees
+    bool wants_frame();
 protected slots:
     void paintEvent(QPaintEvent*) override;
     void update_and_repaint();
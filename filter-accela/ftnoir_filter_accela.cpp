@@ -78,8 +78,8 @@ void FTNoIR_Filter::filter(const double* input, double *output)
 
 void settings_accela::make_splines(spline& rot, spline& trans)
 {
-    rot = spline();
-    trans = spline();
+    rot.removeAllPoints();
+    trans.removeAllPoints();
 
     rot.setMaxInput(rot_gains[0][0]);
     trans.setMaxInput(trans_gains[0][0]);
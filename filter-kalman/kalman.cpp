@@ -145,7 +145,6 @@ PoseVector FTNoIR_Filter::do_kalman_filter(const PoseVector &input, double dt, b
 {
     if (new_input)
     {
-        dt = dt_since_last_input;
         fill_transition_matrix(dt);
         fill_process_noise_cov_matrix(kf_adaptive_process_noise_cov.base_cov, dt);
         kf_adaptive_process_noise_cov.update(kf, dt);
@@ -193,6 +192,8 @@ void FTNoIR_Filter::reset()
     for (int i = 0; i < 6; i++) {
         last_input[i] = 0;
     }
+    last_info.timestamp = 0;
+    last_info.seq = 0;
     first_run = true;
     dt_since_last_input = 0;
 
@@ -204,6 +205,34 @@ void FTNoIR_Filter::reset()
 
 
 void FTNoIR_Filter::filter(const double* input_, double *output_)
+{
+    Eigen::Map<const PoseVector> input(input_, PoseVector::RowsAtCompileTime, 1);
+
+    // Note this is a terrible way to detect when there is a new
+    // frame of tracker input, but it is the best we have.
+    bool new_input = input.cwiseNotEqual(last_input).any();
+
+    filter(input_, output_, new_input, -1);
+}
+
+void FTNoIR_Filter::filter_ex(const double* input_, double *output_, const sample_info& info)
+{
+    // The tracker tells us about new frames and when they were captured.
+    const bool new_input = info.seq != last_info.seq;
+    double sample_dt = -1;
+
+    if (new_input && last_info.timestamp > 0)
+        sample_dt = info.timestamp - last_info.timestamp;
+
+    filter(input_, output_, new_input, sample_dt);
+
+    // after filter(), a reset there would clear it. kept on the first
+    // run as well, the next sample's interval starts from it.
+    if (new_input)
+        last_info = info;
+}
+
+void FTNoIR_Filter::filter(const double* input_, double *output_, bool new_input, double sample_dt)
 {
     // almost non-existent cost, so might as well ...
     Eigen::Map<const PoseVector> input(input_, PoseVector::RowsAtCompileTime, 1);
@@ -223,16 +252,13 @@ void FTNoIR_Filter::filter(const double* input_, double *output_)
         return;
     }
 
-    // Note this is a terrible way to detect when there is a new
-    // frame of tracker input, but it is the best we have.
-    bool new_input = input.cwiseNotEqual(last_input).any();
-
     // Get the time in seconds since last run and restart the timer.
     const double dt = timer.elapsed_seconds();
     dt_since_last_input += dt;
     timer.start();
 
-    output = do_kalman_filter(input, dt, new_input);
+    // Prefer the time between capturing the two frames, if known.
+    output = do_kalman_filter(input, sample_dt > 0 ? sample_dt : dt_since_last_input, new_input);
 
     {
         // Compute deadzone size base on estimated state variance.
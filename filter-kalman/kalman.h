@@ -134,13 +134,16 @@ struct settings : opts {
 class FTNoIR_Filter : public IFilter
 {
     PoseVector do_kalman_filter(const PoseVector &input, double dt, bool new_input);
+    void filter(const double *input, double *output, bool new_input, double sample_dt);
     void fill_transition_matrix(double dt);
     void fill_process_noise_cov_matrix(StateMatrix &target, double dt) const;
 public:
     FTNoIR_Filter();
     void reset();
-    void filter(const double *input, double *output);
+    void filter(const double *input, double *output) override;
+    void filter_ex(const double *input, double *output, const sample_info& info) override;
     PoseVector last_input;
+    sample_info last_info;
     Timer timer;
     bool first_run;
     double dt_since_last_input;
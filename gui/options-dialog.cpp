@@ -73,6 +73,10 @@ OptionsDialog::OptionsDialog(std::function<void(bool)> pause_keybindings) :
     tie_setting(main.use_camera_offset_from_centering, ui.use_center_as_translation_camera_offset);
 
     tie_setting(main.center_method, ui.center_method);
+    tie_setting(main.center_quaternions, ui.center_quaternions);
+
+    tie_setting(main.predict_model, ui.predict_model);
+    tie_setting(main.predict_horizon, ui.predict_horizon);
 
     tie_setting(main.tracklogging_enabled, ui.tracklogging_enabled);
     tie_setting(main.tracklogging_filename, ui.tracklogging_filenameedit);
@@ -182,7 +186,7 @@ void OptionsDialog::browse_datalogging_file()
        and be a known problem. Possible solution is to use the QFileDialog::DontUseNativeDialog flag.
        Since the freeze is apparently random, I'm not sure it helped.
     */
-    QString newfilename = QFileDialog::getSaveFileName(this, tr("Select Filename"), filename, tr("CSV File (*.csv)"), nullptr, QFileDialog::DontUseNativeDialog);
+    QString newfilename = QFileDialog::getSaveFileName(this, tr("Select Filename"), filename, tr("CSV File (*.csv);;Binary track log (*.otlog)"), nullptr, QFileDialog::DontUseNativeDialog);
     if (!newfilename.isEmpty())
         ui.tracklogging_filenameedit->setText(newfilename);
 
@@ -0,0 +1,87 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#include "pipeline-stats.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+constexpr unsigned stage_histogram::size;
+
+stage_histogram::stage_histogram() : count(0u)
+{
+    for (unsigned i = 0; i < size; i++)
+        samples[i].store(0u, std::memory_order_relaxed);
+}
+
+void stage_histogram::add(long long nsecs)
+{
+    using lim = std::numeric_limits<unsigned>;
+
+    const unsigned val = unsigned(std::max(0ll, std::min((long long)lim::max(), nsecs)));
+    const unsigned idx = count.load(std::memory_order_relaxed);
+
+    samples[idx % size].store(val, std::memory_order_relaxed);
+    count.store(idx + 1, std::memory_order_release);
+}
+
+stage_histogram::summary stage_histogram::get() const
+{
+    summary ret { 0, 0, 0, 0 };
+
+    const unsigned cnt = count.load(std::memory_order_acquire);
+    const unsigned n = std::min(cnt, size);
+
+    if (n == 0)
+        return ret;
+
+    // samples may get overwritten while copying, that's fine for a rolling window
+    std::vector<unsigned> tmp(n);
+    for (unsigned i = 0; i < n; i++)
+        tmp[i] = samples[i].load(std::memory_order_relaxed);
+
+    std::sort(tmp.begin(), tmp.end());
+
+    ret.p50 = tmp[n / 2] * 1e-3;
+    ret.p99 = tmp[std::min(n - 1, n * 99 / 100)] * 1e-3;
+    ret.max = tmp[n - 1] * 1e-3;
+    ret.count = cnt;
+
+    return ret;
+}
+
+const char* pipeline_stats::stage_name(pipeline_stage k)
+{
+    static constexpr const char* names[stage_count] =
+    {
+        "tracker", "center", "filter", "mapping", "protocol", "total", "sleep", "latency",
+    };
+
+    return k < stage_count ? names[k] : "";
+}
+
+QString pipeline_stats::dump() const
+{
+    QString ret = QStringLiteral("stage        p50 us     p99 us     max us    samples\n");
+
+    for (unsigned i = 0; i < stage_count; i++)
+    {
+        const pipeline_stage k = pipeline_stage(i);
+        const stage_histogram::summary s = get(k);
+
+        ret += QString("%1 %2 %3 %4 %5\n")
+                .arg(QString(stage_name(k)), -9)
+                .arg(s.p50, 10, 'f', 1)
+                .arg(s.p99, 10, 'f', 1)
+                .arg(s.max, 10, 'f', 1)
+                .arg(s.count, 10);
+    }
+
+    return ret;
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include "compat/timer.hpp"
+#include "export.hpp"
+
+#include <atomic>
+#include <QString>
+
+enum pipeline_stage : unsigned
+{
+    stage_tracker,  // ITracker::data
+    stage_center,   // centering and camera offset math
+    stage_filter,   // IFilter::filter
+    stage_mapping,  // splines, zero, tcomp, invert
+    stage_protocol, // IProtocol::pose
+    stage_total,    // all of the above
+    stage_sleep,    // time spent waiting for the next iteration
+    stage_latency,  // frame capture to IProtocol::pose, trackers with data_ex only
+    stage_count,
+};
+
+// rolling window of the last `size' samples for a single stage.
+// there's one writer, the pipeline thread. readers never block it.
+class OPENTRACK_LOGIC_EXPORT stage_histogram final
+{
+    static constexpr unsigned size = 1024;
+
+    std::atomic<unsigned> samples[size];
+    std::atomic<unsigned> count;
+
+public:
+    struct summary
+    {
+        // in microseconds
+        double p50, p99, max;
+        unsigned count;
+    };
+
+    stage_histogram();
+    void add(long long nsecs);
+    summary get() const;
+};
+
+class OPENTRACK_LOGIC_EXPORT pipeline_stats final
+{
+    stage_histogram stages[stage_count];
+
+public:
+    // measures consecutive stages against a single clock
+    class clock final
+    {
+        pipeline_stats& stats;
+        Timer t;
+
+    public:
+        clock(pipeline_stats& stats) : stats(stats) {}
+        void mark(pipeline_stage k)
+        {
+            stats.add(k, t.elapsed_nsecs());
+            t.start();
+        }
+        void restart() { t.start(); }
+    };
+
+    void add(pipeline_stage k, long long nsecs) { stages[k].add(nsecs); }
+    stage_histogram::summary get(pipeline_stage k) const { return stages[k].get(); }
+
+    static const char* stage_name(pipeline_stage k);
+    QString dump() const;
+};
@@ -0,0 +1,183 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#include "pose-predictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr unsigned pose_predictor::history;
+constexpr double pose_predictor::max_extrapolation;
+constexpr double pose_predictor::max_rot_velocity;
+constexpr double pose_predictor::max_trans_velocity;
+
+pose_predictor::pose_predictor() : count(0), interval(0), last_real(0)
+{
+}
+
+double pose_predictor::wrap_delta(int axis, double delta)
+{
+    // rotation axes wrap around at +-180 degrees
+    if (axis >= 3)
+    {
+        if (delta > 180)
+            delta -= 360;
+        else if (delta < -180)
+            delta += 360;
+    }
+    return delta;
+}
+
+static double wrap_angle(int axis, double value)
+{
+    if (axis >= 3)
+    {
+        value = std::fmod(value + 180, 360);
+        if (value < 0)
+            value += 360;
+        value -= 180;
+    }
+    return value;
+}
+
+double pose_predictor::velocity(int axis, double delta, double dt)
+{
+    const double max = axis >= 3 ? max_rot_velocity : max_trans_velocity;
+    return std::max(-max, std::min(max, wrap_delta(axis, delta) / dt));
+}
+
+void pose_predictor::push(const double* pose, double t, bool synthetic)
+{
+    if (count == history)
+    {
+        std::copy(samples + 1, samples + history, samples);
+        count--;
+    }
+
+    sample& s = samples[count++];
+    s.t = t;
+    s.synthetic = synthetic;
+    std::copy(pose, pose + 6, s.pose);
+}
+
+void pose_predictor::update(const double* pose, double timestamp, bool fresh, bool sequenced, double now)
+{
+    if (count == 0)
+    {
+        push(pose, timestamp, false);
+        last_real = timestamp;
+        return;
+    }
+
+    if (fresh)
+    {
+        // the real sample was only late, not missing
+        while (count > 1 && samples[count - 1].synthetic && samples[count - 1].t >= timestamp)
+            count--;
+
+        if (timestamp > samples[count - 1].t)
+        {
+            const double dt = timestamp - last_real;
+            if (dt > 0)
+                interval = interval > 0 ? interval * .8 + dt * .2 : dt;
+            push(pose, timestamp, false);
+            last_real = timestamp;
+        }
+        return;
+    }
+
+    // trackers without sequence numbers only report changes, a stationary
+    // head looks like a stalled tracker. once the next sample is overdue,
+    // assume it came in on time with the same pose so that velocity decays.
+    // capture times of sequenced trackers lag behind `now', their samples
+    // would look overdue all the time.
+    const sample& last = samples[count - 1];
+
+    if (!sequenced && interval > 0 && now - last.t > interval * 1.5)
+        push(last.pose, last.t + interval, true);
+}
+
+void pose_predictor::interpolate(double t, double* out) const
+{
+    // find the pair of samples around t, clamping to the oldest one
+    unsigned k = count - 1;
+    while (k > 0 && samples[k - 1].t > t)
+        k--;
+
+    if (k == 0)
+    {
+        std::copy(samples[0].pose, samples[0].pose + 6, out);
+        return;
+    }
+
+    const sample& a = samples[k - 1];
+    const sample& b = samples[k];
+    const double span = b.t - a.t;
+    const double x = span > 0 ? (t - a.t) / span : 1;
+
+    for (int i = 0; i < 6; i++)
+        out[i] = wrap_angle(i, a.pose[i] + wrap_delta(i, b.pose[i] - a.pose[i]) * x);
+}
+
+void pose_predictor::extrapolate(model m, double t, double* out) const
+{
+    const sample& s2 = samples[count - 1];
+    const double dt = std::min(max_extrapolation, t - s2.t);
+
+    if (m == model_none || count < 2)
+    {
+        std::copy(s2.pose, s2.pose + 6, out);
+        return;
+    }
+
+    const sample& s1 = samples[count - 2];
+    const double dt21 = s2.t - s1.t;
+
+    if (!(dt21 > 0))
+    {
+        std::copy(s2.pose, s2.pose + 6, out);
+        return;
+    }
+
+    const bool accel = m == model_acceleration && count > 2 && s1.t > samples[count - 3].t;
+
+    for (int i = 0; i < 6; i++)
+    {
+        const double v2 = velocity(i, s2.pose[i] - s1.pose[i], dt21);
+        double ret = s2.pose[i] + v2 * dt;
+
+        if (accel)
+        {
+            const sample& s0 = samples[count - 3];
+            const double dt10 = s1.t - s0.t;
+            const double v1 = velocity(i, s1.pose[i] - s0.pose[i], dt10);
+            const double a = (v2 - v1) / ((dt21 + dt10) * .5);
+
+            // v2 is the velocity halfway between s1 and s2
+            ret += a * dt * (dt21 * .5 + dt * .5);
+        }
+
+        out[i] = wrap_angle(i, ret);
+    }
+}
+
+void pose_predictor::predict(model m, double t, double horizon, double* out) const
+{
+    if (count == 0)
+    {
+        std::fill(out, out + 6, 0.);
+        return;
+    }
+
+    const double target = t + horizon;
+
+    if (target < samples[count - 1].t)
+        interpolate(target, out);
+    else
+        extrapolate(m, target, out);
+}
@@ -0,0 +1,70 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include "export.hpp"
+
+// trackers deliver at camera rate, the pipeline ticks faster than that.
+// keeps the last few tracker samples with their capture time and
+// evaluates the pose at "now + horizon", interpolating between samples or
+// extrapolating past the newest one.
+
+class OPENTRACK_LOGIC_EXPORT pose_predictor final
+{
+public:
+    enum model
+    {
+        model_none,
+        model_velocity,
+        model_acceleration,
+    };
+
+private:
+    static constexpr unsigned history = 3;
+
+    // don't extrapolate further than this past the newest sample
+    static constexpr double max_extrapolation = .1;
+    // degrees and centimeters per second. faster than any head moves,
+    // anything above is noise over a short time step.
+    static constexpr double max_rot_velocity = 1000;
+    static constexpr double max_trans_velocity = 300;
+
+    struct sample
+    {
+        double t;
+        double pose[6];
+        // repeated pose standing in for an overdue sample
+        bool synthetic;
+    };
+
+    sample samples[history];
+    unsigned count;
+    // smoothed time between tracker samples, zero until known
+    double interval;
+    // capture time of the newest real sample
+    double last_real;
+
+    static double wrap_delta(int axis, double delta);
+    static double velocity(int axis, double delta, double dt);
+    void push(const double* pose, double t, bool synthetic);
+    void interpolate(double t, double* out) const;
+    void extrapolate(model m, double t, double* out) const;
+
+public:
+    pose_predictor();
+
+    // call every tick with the tracker's latest pose, times in seconds.
+    // sequenced: the tracker reports capture times and sequence numbers.
+    // otherwise, if no fresh sample arrives, the last one gets repeated
+    // once it's overdue.
+    void update(const double* pose, double timestamp, bool fresh, bool sequenced, double now);
+    // horizon in seconds, may be negative to interpolate instead
+    void predict(model m, double t, double horizon, double* out) const;
+    void reset() { count = 0; interval = 0; last_real = 0; }
+};
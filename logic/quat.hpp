@@ -0,0 +1,83 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include "simple-mat.hpp"
+#include <cmath>
+
+namespace euler {
+
+// unit quaternion, same rotation convention as euler_to_rmat:
+// R = Rz(-yaw) * Ry(-pitch) * Rx(-roll)
+
+struct quat final
+{
+    double w, x, y, z;
+
+    quat() : w(1), x(0), y(0), z(0) {}
+    quat(double w, double x, double y, double z) : w(w), x(x), y(y), z(z) {}
+
+    quat operator*(const quat& q) const
+    {
+        return quat(w * q.w - x * q.x - y * q.y - z * q.z,
+                    w * q.x + x * q.w + y * q.z - z * q.y,
+                    w * q.y - x * q.z + y * q.w + z * q.x,
+                    w * q.z + x * q.y - y * q.x + z * q.w);
+    }
+
+    // inverse, for unit quaternions
+    quat conj() const { return quat(w, -x, -y, -z); }
+
+    bool is_nan() const
+    {
+        using std::isfinite;
+        return !(isfinite(w) && isfinite(x) && isfinite(y) && isfinite(z));
+    }
+
+    // radians
+    static quat from_yaw(double a) { return quat(std::cos(a * -.5), 0, 0, std::sin(a * -.5)); }
+    static quat from_pitch(double a) { return quat(std::cos(a * -.5), 0, std::sin(a * -.5), 0); }
+    static quat from_roll(double a) { return quat(std::cos(a * -.5), std::sin(a * -.5), 0, 0); }
+};
+
+inline quat euler_to_quat(const euler_t& input)
+{
+    const double hy = input(0) * -.5, hp = input(1) * -.5, hr = input(2) * -.5;
+
+    using std::cos;
+    using std::sin;
+
+    const double cy = cos(hy), sy = sin(hy);
+    const double cp = cos(hp), sp = sin(hp);
+    const double cr = cos(hr), sr = sin(hr);
+
+    // qz(yaw) * qy(pitch) * qx(roll), expanded
+    return quat(cy * cp * cr + sy * sp * sr,
+                cy * cp * sr - sy * sp * cr,
+                cy * sp * cr + sy * cp * sr,
+                sy * cp * cr - cy * sp * sr);
+}
+
+inline rmat quat_to_rmat(const quat& q)
+{
+    const double xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const double xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const double wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return rmat(1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+                2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+                2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy));
+}
+
+inline euler_t quat_to_euler(const quat& q)
+{
+    return rmat_to_euler(quat_to_rmat(q));
+}
+
+} // end ns euler
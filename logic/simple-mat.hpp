@@ -261,6 +261,31 @@ Mat<num, h_, w_> operator*(const Mat<num, h_, w_>& self, num other)
     return ret;
 }
 
+// unrolled kernels for the 3x3 rotation math that runs on every pipeline tick.
+// being non-templates, these take precedence over Mat::operator*.
+
+inline dmat<3, 3> operator*(const dmat<3, 3>& a, const dmat<3, 3>& b)
+{
+    return dmat<3, 3>(a(0, 0) * b(0, 0) + a(0, 1) * b(1, 0) + a(0, 2) * b(2, 0),
+                      a(0, 0) * b(0, 1) + a(0, 1) * b(1, 1) + a(0, 2) * b(2, 1),
+                      a(0, 0) * b(0, 2) + a(0, 1) * b(1, 2) + a(0, 2) * b(2, 2),
+
+                      a(1, 0) * b(0, 0) + a(1, 1) * b(1, 0) + a(1, 2) * b(2, 0),
+                      a(1, 0) * b(0, 1) + a(1, 1) * b(1, 1) + a(1, 2) * b(2, 1),
+                      a(1, 0) * b(0, 2) + a(1, 1) * b(1, 2) + a(1, 2) * b(2, 2),
+
+                      a(2, 0) * b(0, 0) + a(2, 1) * b(1, 0) + a(2, 2) * b(2, 0),
+                      a(2, 0) * b(0, 1) + a(2, 1) * b(1, 1) + a(2, 2) * b(2, 1),
+                      a(2, 0) * b(0, 2) + a(2, 1) * b(1, 2) + a(2, 2) * b(2, 2));
+}
+
+inline dmat<3, 1> operator*(const dmat<3, 3>& a, const dmat<3, 1>& v)
+{
+    return dmat<3, 1>(a(0, 0) * v(0) + a(0, 1) * v(1) + a(0, 2) * v(2),
+                      a(1, 0) * v(0) + a(1, 1) * v(1) + a(1, 2) * v(2),
+                      a(2, 0) * v(0) + a(2, 1) * v(1) + a(2, 2) * v(2));
+}
+
 namespace euler {
 
 template<int y, int x> using dmat = Mat<double, y, x>;
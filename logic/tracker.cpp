@@ -27,7 +27,10 @@
 Tracker::Tracker(Mappings &m, SelectedLibraries &libs, TrackLogger &logger) :
     m(m),
     libs(libs),
-    logger(logger)
+    logger(logger),
+    camera_offset_valid(false),
+    quat_active(s.center_quaternions),
+    sample()
 {
     set(f_center, s.center_at_startup);
 }
@@ -50,6 +53,23 @@ Tracker::rmat Tracker::get_camera_offset_matrix(double c)
     return euler::euler_to_rmat(off);
 }
 
+void Tracker::update_camera_offset()
+{
+    const int off[3] = { s.camera_yaw, s.camera_pitch, s.camera_roll };
+
+    if (camera_offset_valid && std::equal(off, off + 3, camera_offset))
+        return;
+
+    std::copy(off, off + 3, camera_offset);
+    camera_offset_valid = true;
+
+    const euler_t tmp = -d2r * euler_t(off[0], off[1], off[2]);
+
+    scaled_rotation.camera = euler::euler_to_rmat(c_div * tmp);
+    real_rotation.camera = euler::euler_to_rmat(tmp);
+    q_rotation.camera = euler::euler_to_quat(tmp);
+}
+
 double Tracker::map(double pos, Map& axis)
 {
     bool altp = (pos < 0) && axis.opts.altp;
@@ -98,71 +118,50 @@ static bool is_nan(const dmat<u,w>& r)
 constexpr double Tracker::c_mult;
 constexpr double Tracker::c_div;
 
-void Tracker::logic()
+bool Tracker::take_center_request()
 {
-    using namespace euler;
+    if (!get(f_center))
+        return false;
 
-    logger.write_dt();
-    logger.reset_dt();
-
-    Pose value, raw;
+    bool can_center = false;
 
     for (int i = 0; i < 6; i++)
-    {
-        auto& axis = m(i);
-        int k = axis.opts.src;
-        if (k < 0 || k >= 6)
-            value(i) = 0;
-        else
-            value(i) = newpose(k);
-        raw(i) = newpose(i);
-    }
+        if (std::fabs(newpose(i)) != 0)
+        {
+            can_center = true;
+            break;
+        }
 
-    logger.write_pose(raw); // raw
+    if (!can_center)
+        return false;
 
-    if (is_nan(raw))
-        raw = last_raw;
+    set(f_center, false);
 
-    // TODO split this function, it's too big
+    if (libs.pFilter)
+        libs.pFilter->center();
+
+    return true;
+}
+
+bool Tracker::rotate_matrices(Pose& value)
+{
+    using namespace euler;
 
     {
         euler_t tmp = d2r * euler_t(&value[Yaw]);
         scaled_rotation.rotation = euler_to_rmat(c_div * tmp);
         real_rotation.rotation = euler_to_rmat(tmp);
-        tait_bryan_to_matrices(c_div * tmp, scaled_rotation.rr, scaled_rotation.ry, scaled_rotation.rp);
     }
 
-    scaled_rotation.camera = get_camera_offset_matrix(c_div);
-    real_rotation.camera = get_camera_offset_matrix(1);
-
     scaled_rotation.rotation = scaled_rotation.camera * scaled_rotation.rotation;
     real_rotation.rotation = real_rotation.camera * real_rotation.rotation;
 
-    bool nanp = is_nan(value) || is_nan(scaled_rotation.rotation) || is_nan(real_rotation.rotation);
+    const bool nanp = is_nan(value) || is_nan(scaled_rotation.rotation) || is_nan(real_rotation.rotation);
 
     if (!nanp)
     {
-        bool can_center = false;
-
-        if (get(f_center) && !nanp)
-        {
-            using std::fabs;
-
-            for (int i = 0; i < 6; i++)
-                if (fabs(newpose(i)) != 0)
-                {
-                    can_center = true;
-                    break;
-                }
-        }
-
-        if (can_center)
+        if (take_center_request())
         {
-            set(f_center, false);
-
-            if (libs.pFilter)
-                libs.pFilter->center();
-
             if (libs.pTracker->center())
             {
                 scaled_rotation.rotation = scaled_rotation.camera.t();
@@ -227,7 +226,7 @@ void Tracker::logic()
         euler_t pos = euler_t(&value[TX]) - t_center;
 
         if (s.use_camera_offset_from_centering)
-            t_compensate(real_rotation.rot_center.t() * real_rotation.camera.t(), pos, pos, false);
+            t_compensate((real_rotation.camera * real_rotation.rot_center).t(), pos, pos, false);
         else
             t_compensate(real_rotation.camera.t(), pos, pos, false);
 
@@ -238,8 +237,121 @@ void Tracker::logic()
         }
     }
 
+    return nanp;
+}
+
+bool Tracker::rotate_quat(Pose& value)
+{
+    using namespace euler;
+
+    // same steps as rotate_matrices(), but there's a single conversion
+    // back to euler angles, and no need for the c_mult scaling.
+
+    quat rotation = q_rotation.camera * euler_to_quat(d2r * euler_t(&value[Yaw]));
+
+    const bool nanp = is_nan(value) || rotation.is_nan();
+
+    if (!nanp && take_center_request())
+    {
+        if (libs.pTracker->center())
+        {
+            rotation = quat();
+            q_rotation.center = euler_t();
+        }
+        else
+        {
+            q_rotation.rot_center = rotation.conj();
+            q_rotation.center = quat_to_euler(rotation);
+        }
+
+        t_center = euler_t(&value(TX));
+    }
+
+    switch (s.center_method)
+    {
+    // inertial
+    case 0:
+    default:
+        rotation = q_rotation.rot_center * rotation;
+        break;
+    // camera
+    case 1:
+        rotation = rotation * q_rotation.rot_center;
+        break;
+    // alternative camera
+    case 2:
+    {
+        const euler_t d = quat_to_euler(rotation) - q_rotation.center;
+
+        // roll yaw pitch
+        rotation = quat::from_roll(d(2)) * quat::from_yaw(d(0)) * quat::from_pitch(d(1));
+        break;
+    }
+    }
+
+    const euler_t rot = r2d * quat_to_euler(rotation);
+    euler_t pos = euler_t(&value[TX]) - t_center;
+
+    if (s.use_camera_offset_from_centering)
+        t_compensate(quat_to_rmat(q_rotation.rot_center.conj() * q_rotation.camera.conj()), pos, pos, false);
+    else
+        t_compensate(quat_to_rmat(q_rotation.camera.conj()), pos, pos, false);
+
+    for (int i = 0; i < 3; i++)
+    {
+        value(i) = pos(i);
+        value(i+3) = rot(i);
+    }
+
+    return nanp;
+}
+
+void Tracker::logic(pipeline_stats::clock& clk)
+{
+    using namespace euler;
+
+    logger.write_dt();
+    logger.reset_dt();
+
+    Pose value, raw;
+
+    for (int i = 0; i < 6; i++)
+    {
+        auto& axis = m(i);
+        int k = axis.opts.src;
+        if (k < 0 || k >= 6)
+            value(i) = 0;
+        else
+            value(i) = predicted(k);
+        raw(i) = newpose(i);
+    }
+
+    logger.write_pose(raw); // raw
+
+    if (is_nan(raw))
+        raw = last_raw;
+
+    // only rebuilt when the camera offset settings change
+    update_camera_offset();
+
+    {
+        const bool use_quat = s.center_quaternions;
+
+        // the two paths keep separate centering state, switching between
+        // them while running needs a fresh center
+        if (use_quat != quat_active)
+        {
+            quat_active = use_quat;
+            set(f_center, true);
+        }
+    }
+
+    bool nanp = quat_active ? rotate_quat(value) : rotate_matrices(value);
+
     logger.write_pose(value); // "corrected" - after various transformations to account for camera position
 
+    clk.mark(stage_center);
+
     // whenever something can corrupt its internal state due to nan/inf, elide the call
     if (is_nan(value))
     {
@@ -251,7 +363,9 @@ void Tracker::logic()
         Pose tmp(value);
 
         if (libs.pFilter)
-            libs.pFilter->filter(tmp, value);
+            libs.pFilter->filter_ex(tmp, value, sample);
+
+        clk.mark(stage_filter);
 
         logger.write_pose(value); // "filtered"
 
@@ -301,19 +415,108 @@ void Tracker::logic()
             (void) map(value(i), m(i));
     }
 
+    clk.mark(stage_mapping);
+
     libs.pProtocol->pose(value);
 
+    clk.mark(stage_protocol);
+
     last_mapped = value;
     last_raw = raw;
 
-    QMutexLocker foo(&mtx);
-    output_pose = value;
-    raw_6dof = raw;
+    {
+        published_poses tmp;
+        for (int i = 0; i < 6; i++)
+        {
+            tmp.mapped[i] = value(i);
+            tmp.raw[i] = raw(i);
+        }
+        published.store(tmp);
+    }
 
     logger.reset_dt();
     logger.next_line();
 }
 
+void Tracker::predict(bool fresh, bool sequenced)
+{
+    const pose_predictor::model model = pose_predictor::model(int(s.predict_model));
+
+    if (model == pose_predictor::model_none)
+    {
+        predictor.reset();
+        predicted = newpose;
+        return;
+    }
+
+    const double t = Timer::monotonic_seconds();
+
+    predictor.update(newpose, sample.timestamp, fresh, sequenced, t);
+    predictor.predict(model, t, s.predict_horizon * 1e-3, predicted);
+}
+
+sample_info Tracker::make_sample_info(const Pose& pose) const
+{
+    // best we can do for trackers without data_ex()
+    sample_info ret = sample;
+
+    for (int i = 0; i < 6; i++)
+        if (pose(i) != last_tracker_pose(i))
+        {
+            ret.timestamp = Timer::monotonic_seconds();
+            ret.seq++;
+            break;
+        }
+
+    return ret;
+}
+
+void Tracker::iteration(pipeline_stats::clock& clk)
+{
+    Pose tmp;
+    sample_info info;
+
+    // only trackers implementing data_ex know when the frame was taken
+    const bool captured = libs.pTracker->data_ex(tmp, info);
+
+    if (!captured)
+    {
+        libs.pTracker->data(tmp);
+        info = make_sample_info(tmp);
+    }
+
+    clk.mark(stage_tracker);
+
+    const bool fresh = info.seq != sample.seq;
+    sample = info;
+    last_tracker_pose = tmp;
+
+    if (get(f_enabled))
+        for (int i = 0; i < 6; i++)
+            newpose[i] = elide_nan(tmp(i), newpose(i));
+
+    predict(fresh, captured);
+    logic(clk);
+
+    if (captured && fresh)
+    {
+        const double latency = Timer::monotonic_seconds() - sample.timestamp;
+        // replayed samples can run ahead of the clock
+        if (latency >= 0)
+            stats.add(stage_latency, (long long)(latency * 1e9));
+    }
+}
+
+void Tracker::step()
+{
+    pipeline_stats::clock clk(stats);
+    Timer iter_timer;
+
+    iteration(clk);
+
+    stats.add(stage_total, iter_timer.elapsed_nsecs());
+}
+
 void Tracker::run()
 {
 #if defined(_WIN32)
@@ -322,37 +525,43 @@ void Tracker::run()
 
     setPriority(QThread::HighPriority);
 
-    {
-        static constexpr const char* posechannels[6] = { "TX", "TY", "TZ", "Yaw", "Pitch", "Roll" };
-        static constexpr const char* datachannels[5] = { "dt", "raw", "corrected", "filtered", "mapped" };
-        logger.write(datachannels[0]);
-        char buffer[128];
-        for (unsigned j = 1; j < 5; ++j)
-        {
-            for (unsigned i = 0; i < 6; ++i)
-            {
-                std::sprintf(buffer, "%s%s", datachannels[j], posechannels[i]);
-                logger.write(buffer);
-            }
-        }
-        logger.next_line();
-    }
+    logger.write_header();
 
     t.start();
     logger.reset_dt();
 
+    // trackers signaling new samples wake us up right away. we still tick
+    // on timeout so that filters keep converging while the camera stalls.
+    // prediction wants the output moving between frames, so it ticks as
+    // often as the sleeping loop does.
+    const bool event_driven = libs.pTracker->is_event_driven();
+
+    static constexpr long const_sleep_us = 4000;
+    static constexpr unsigned max_wait_ms = unsigned(const_sleep_us * 4 / 1000);
+    static constexpr unsigned predict_wait_ms = unsigned(const_sleep_us / 1000);
+
+    pipeline_stats::clock clk(stats);
+    Timer iter_timer;
+
     while (!get(f_should_quit))
     {
-        Pose tmp;
-        libs.pTracker->data(tmp);
+        if (event_driven)
+        {
+            const bool predicting = int(s.predict_model) != pose_predictor::model_none;
+            (void) libs.pTracker->wait_for_new_data(predicting ? predict_wait_ms : max_wait_ms);
+        }
 
-        if (get(f_enabled))
-            for (int i = 0; i < 6; i++)
-                newpose[i] = elide_nan(tmp(i), newpose(i));
+        stats.add(stage_sleep, iter_timer.elapsed_nsecs());
+        iter_timer.start();
+        clk.restart();
+
+        iteration(clk);
 
-        logic();
+        stats.add(stage_total, iter_timer.elapsed_nsecs());
+        iter_timer.start();
 
-        static constexpr long const_sleep_us = 4000;
+        if (event_driven)
+            continue;
 
         using std::max;
         using std::min;
@@ -386,12 +595,12 @@ void Tracker::run()
 
 void Tracker::get_raw_and_mapped_poses(double* mapped, double* raw) const
 {
-    QMutexLocker foo(&const_cast<Tracker&>(*this).mtx);
+    const published_poses tmp = published.load();
 
     for (int i = 0; i < 6; i++)
     {
-        raw[i] = raw_6dof(i);
-        mapped[i] = output_pose(i);
+        raw[i] = tmp.raw[i];
+        mapped[i] = tmp.mapped[i];
     }
 }
 
@@ -12,17 +12,20 @@
 
 #include "compat/pi-constant.hpp"
 #include "compat/timer.hpp"
+#include "compat/seqlock.hpp"
 #include "api/plugin-support.hpp"
 #include "mappings.hpp"
 #include "simple-mat.hpp"
+#include "quat.hpp"
 #include "selected-libraries.hpp"
 
 #include "spline-widget/spline.hpp"
 #include "main-settings.hpp"
 #include "options/options.hpp"
 #include "tracklogger.hpp"
+#include "pipeline-stats.hpp"
+#include "pose-predictor.hpp"
 
-#include <QMutex>
 #include <QThread>
 
 #include <atomic>
@@ -87,27 +90,40 @@ class OPENTRACK_LOGIC_EXPORT Tracker : private QThread, private bits
 private:
     using rmat = euler::rmat;
     using euler_t = euler::euler_t;
+    using quat = euler::quat;
 
-    QMutex mtx;
     main_settings s;
     Mappings& m;
 
     Timer t;
-    Pose output_pose, raw_6dof, last_mapped, last_raw;
+    Pose last_mapped, last_raw;
+
+    struct published_poses
+    {
+        double mapped[6], raw[6];
+    };
+
+    // written by the pipeline thread, read by any number of UI-side consumers
+    seqlock<published_poses> published;
 
     Pose newpose;
+    // what the rest of the pipeline sees, newpose unless prediction is on
+    Pose predicted;
+    pose_predictor predictor;
     SelectedLibraries const& libs;
     // The owner of the reference is the main window.
     // This design might be usefull if we decide later on to swap out
     // the logger while the tracker is running.
     TrackLogger &logger;
 
+    pipeline_stats stats;
+
     struct state
     {
         rmat center_yaw, center_pitch, center_roll;
         rmat rot_center;
         rmat camera;
-        rmat rotation, ry, rp, rr;
+        rmat rotation;
 
         state() : center_yaw(rmat::eye()), center_pitch(rmat::eye()), center_roll(rmat::eye()), rot_center(rmat::eye())
         {}
@@ -116,9 +132,35 @@ private:
     state real_rotation, scaled_rotation;
     euler_t t_center;
 
+    // centering state for the quaternion path
+    struct quat_state
+    {
+        quat camera, rot_center;
+        // for the alternative camera method, in radians
+        euler_t center;
+    };
+
+    quat_state q_rotation;
+
+    // camera yaw, pitch, roll the camera matrices were built for
+    int camera_offset[3];
+    bool camera_offset_valid;
+    bool quat_active;
+
+    // the sample being processed, and the tracker's output on the last tick
+    sample_info sample;
+    Pose last_tracker_pose;
+
     double map(double pos, Map& axis);
-    void logic();
+    void logic(pipeline_stats::clock& clk);
+    bool take_center_request();
+    bool rotate_matrices(Pose& value);
+    bool rotate_quat(Pose& value);
+    void iteration(pipeline_stats::clock& clk);
+    void predict(bool fresh, bool sequenced);
+    sample_info make_sample_info(const Pose& pose) const;
     void t_compensate(const rmat& rmat, const euler_t& ypr, euler_t& output, bool rz);
+    void update_camera_offset();
     void run() override;
 
     static constexpr double pi = OPENTRACK_PI;
@@ -134,7 +176,12 @@ public:
 
     rmat get_camera_offset_matrix(double c);
     void get_raw_and_mapped_poses(double* mapped, double* raw) const;
+    // per-stage timings, safe to read from any thread
+    const pipeline_stats& get_stats() const { return stats; }
     void start() { QThread::start(); }
+    // run a single iteration synchronously on the calling thread, without
+    // waiting for the tracker. for headless replay; don't mix with start().
+    void step();
 
     void center() { set(f_center, true); }
 
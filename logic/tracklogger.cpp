@@ -1,8 +1,32 @@
 #include "tracklogger.hpp"
 #include "tracker.h"
+#include "compat/sleep.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <QDebug>
 
 TrackLogger::~TrackLogger() {}
 
+void TrackLogger::write_header()
+{
+    static constexpr const char* posechannels[6] = { "TX", "TY", "TZ", "Yaw", "Pitch", "Roll" };
+    static constexpr const char* datachannels[5] = { "dt", "raw", "corrected", "filtered", "mapped" };
+    write(datachannels[0]);
+    char buffer[128];
+    for (unsigned j = 1; j < 5; ++j)
+    {
+        for (unsigned i = 0; i < 6; ++i)
+        {
+            std::sprintf(buffer, "%s%s", datachannels[j], posechannels[i]);
+            write(buffer);
+        }
+    }
+    next_line();
+}
+
 void TrackLogger::reset_dt()
 {
     t.start();
@@ -41,7 +65,128 @@ void TrackLoggerCSV::write(const double *p, int n)
 
 void TrackLoggerCSV::next_line()
 {
-    out << std::endl;
+    // no std::endl, flushing on every line is too slow for the pipeline thread
+    out.put('\n');
     first_col = true;
 }
 
+constexpr unsigned TrackLoggerBinary::record::value_count;
+constexpr unsigned TrackLoggerBinary::ring_size;
+constexpr unsigned TrackLoggerBinary::writer_period_ms;
+
+const TrackLoggerBinary::header TrackLoggerBinary::default_header =
+{
+    { 'o', 't', 'r', 'k', 'l', 'o', 'g', '\0' },
+    1,
+    sizeof(TrackLoggerBinary::record),
+};
+
+TrackLoggerBinary::TrackLoggerBinary(const QString& filename) :
+    out(filename.toStdString(), std::ios::out | std::ios::binary | std::ios::trunc),
+    ring(new record[ring_size]),
+    head(0u), tail(0u), dropped(0u),
+    should_quit(false),
+    cur_pos(0)
+{
+    if (out.is_open())
+    {
+        out.write(reinterpret_cast<const char*>(&default_header), sizeof(default_header));
+        writer = std::thread(&TrackLoggerBinary::writer_loop, this);
+    }
+}
+
+TrackLoggerBinary::~TrackLoggerBinary()
+{
+    should_quit = true;
+    if (writer.joinable())
+        writer.join();
+
+    if (dropped > 0)
+        qDebug() << "tracklogger: dropped" << unsigned(dropped) << "records";
+}
+
+void TrackLoggerBinary::write(const double *p, int n)
+{
+    const unsigned len = std::min(unsigned(n), record::value_count - cur_pos);
+    std::memcpy(cur.values + cur_pos, p, len * sizeof(double));
+    cur_pos += len;
+}
+
+void TrackLoggerBinary::next_line()
+{
+    if (cur_pos == record::value_count)
+    {
+        const unsigned h = head.load(std::memory_order_relaxed);
+
+        if (h - tail.load(std::memory_order_acquire) >= ring_size)
+            dropped++;
+        else
+        {
+            ring[h % ring_size] = cur;
+            head.store(h + 1, std::memory_order_release);
+        }
+    }
+
+    cur_pos = 0;
+}
+
+void TrackLoggerBinary::drain()
+{
+    const unsigned h = head.load(std::memory_order_acquire);
+    unsigned t_ = tail.load(std::memory_order_relaxed);
+
+    for (; t_ != h; t_++)
+        out.write(reinterpret_cast<const char*>(&ring[t_ % ring_size]), sizeof(record));
+
+    tail.store(t_, std::memory_order_release);
+}
+
+void TrackLoggerBinary::writer_loop()
+{
+    while (!should_quit)
+    {
+        drain();
+        portable::sleep(writer_period_ms);
+    }
+
+    drain();
+    out.flush();
+}
+
+bool TrackLoggerBinary::convert_to_csv(const QString& binary_filename, const QString& csv_filename)
+{
+    std::ifstream in(binary_filename.toStdString(), std::ios::in | std::ios::binary);
+
+    if (!in.is_open())
+        return false;
+
+    header hdr;
+
+    if (!in.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) ||
+        std::memcmp(hdr.magic, default_header.magic, sizeof(hdr.magic)) ||
+        hdr.version != default_header.version ||
+        hdr.record_size != default_header.record_size)
+    {
+        qDebug() << "tracklogger:" << binary_filename << "isn't a binary track log";
+        return false;
+    }
+
+    TrackLoggerCSV csv(csv_filename);
+
+    if (!csv.is_open())
+        return false;
+
+    csv.write_header();
+
+    record r;
+
+    while (in.read(reinterpret_cast<char*>(&r), sizeof(r)))
+    {
+        csv.write(r.values, 1);
+        for (unsigned i = 0; i < 4; i++)
+            csv.write_pose(r.values + 1 + i * 6);
+        csv.next_line();
+    }
+
+    return true;
+}
@@ -4,6 +4,10 @@
 #include "compat/timer.hpp"
 
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstdint>
 #include <QString>
 #include <QMessageBox>
 #include <QWidget>
@@ -41,6 +45,7 @@ public:
         write(p, 6);
     }
 
+    void write_header();
     void reset_dt();
     void write_dt();
 };
@@ -63,3 +68,56 @@ public:
     void next_line() override;
 };
 
+
+// fixed-size binary records. the pipeline thread only copies into
+// a ring buffer, the file is written from a background thread.
+class OPENTRACK_LOGIC_EXPORT TrackLoggerBinary : public TrackLogger
+{
+public:
+    // native byte order
+    struct header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t record_size;
+    };
+
+    // dt, then raw, corrected, filtered and mapped poses
+    struct record
+    {
+        static constexpr unsigned value_count = 1 + 4 * 6;
+        double values[value_count];
+    };
+
+    TrackLoggerBinary(const QString& filename);
+    ~TrackLoggerBinary() override;
+
+    bool is_open() const { return out.is_open(); }
+    // column names are implied by the format
+    void write(const char *) override {}
+    void write(const double *p, int n) override;
+    void next_line() override;
+
+    unsigned dropped_records() const { return dropped; }
+
+    static bool convert_to_csv(const QString& binary_filename, const QString& csv_filename);
+
+private:
+    static constexpr unsigned ring_size = 1024;
+    static constexpr unsigned writer_period_ms = 50;
+    static const header default_header;
+
+    std::ofstream out;
+
+    std::unique_ptr<record[]> ring;
+    std::atomic<unsigned> head, tail, dropped;
+    std::atomic<bool> should_quit;
+
+    record cur;
+    unsigned cur_pos;
+
+    std::thread writer;
+
+    void writer_loop();
+    void drain();
+};
@@ -16,8 +16,24 @@ std::shared_ptr<TrackLogger> Work::make_logger(const main_settings &s)
         }
         else
         {
-            auto logger = std::make_shared<TrackLoggerCSV>(s.tracklogging_filename);
-            if (!logger->is_open())
+            const QString filename = s.tracklogging_filename;
+            std::shared_ptr<TrackLogger> logger;
+            bool is_open;
+
+            if (filename.endsWith(".otlog", Qt::CaseInsensitive))
+            {
+                auto logger_ = std::make_shared<TrackLoggerBinary>(filename);
+                is_open = logger_->is_open();
+                logger = logger_;
+            }
+            else
+            {
+                auto logger_ = std::make_shared<TrackLoggerCSV>(filename);
+                is_open = logger_->is_open();
+                logger = logger_;
+            }
+
+            if (!is_open)
             {
                 logger = nullptr;
                 QMessageBox::warning(nullptr, "Logging Error",
@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <typeinfo>
 #include <typeindex>
+#include <atomic>
 #include <QString>
 #include <QPointF>
 #include <QList>
@@ -132,6 +133,26 @@ template<> struct value_element_type<float, void> { using type = double; };
 
 template<typename t> using value_element_type_t = typename value_element_type<t>::type;
 
+// scalar values are mirrored in an atomic so that real-time threads
+// can read them without going through the bundle's mutex and QVariant.
+template<typename t, typename Enable = void>
+struct value_cache
+{
+    static constexpr bool enabled = false;
+    void store(const t&) {}
+    t load() const { return t(); }
+};
+
+template<typename t>
+struct value_cache<t, typename std::enable_if<std::is_arithmetic<t>::value>::type>
+{
+    static constexpr bool enabled = true;
+    std::atomic<t> val;
+    value_cache() : val(t()) {}
+    void store(const t& x) { val.store(x, std::memory_order_relaxed); }
+    t load() const { return val.load(std::memory_order_relaxed); }
+};
+
 }
 
 template<typename t>
@@ -148,7 +169,7 @@ public:
     t operator=(const t& datum)
     {
         const element_type tmp = static_cast<element_type>(datum);
-        if (tmp != get())
+        if (tmp != static_cast<element_type>(get_uncached()))
             store(tmp);
         return datum;
     }
@@ -156,13 +177,18 @@ public:
     static constexpr const Qt::ConnectionType DIRECT_CONNTYPE = Qt::AutoConnection;
     static constexpr const Qt::ConnectionType SAFE_CONNTYPE = Qt::AutoConnection;
 
-    value(bundle b, const QString& name, t def) : base_value(b, name, &is_equal, std::type_index(typeid(element_type))), def(def)
+    value(bundle b, const QString& name, t def) :
+        base_value(b, name, &is_equal, std::type_index(typeid(element_type))),
+        def(def),
+        // nameless bundles don't notify their values, see bundle::store_kv
+        use_cache(cache_type::enabled && b->name().size() > 0)
     {
         QObject::connect(b.get(), SIGNAL(reloading()),
                          this, SLOT(reload()),
                          DIRECT_CONNTYPE);
         if (!b->contains(name) || b->get<QVariant>(name).type() == QVariant::Invalid)
             *this = def;
+        refresh_cache();
     }
 
     value(bundle b, const char* name, t def) : value(b, QString(name), def)
@@ -171,10 +197,9 @@ public:
 
     t get() const
     {
-        t val = b->contains(self_name)
-                ? static_cast<t>(b->get<element_type>(self_name))
-                : def;
-        return detail::value_get_traits<t>::get(val, def);
+        if (use_cache)
+            return static_cast<t>(cache.load());
+        return get_uncached();
     }
 
     operator t() const { return get(); }
@@ -186,11 +211,30 @@ public:
 
     void bundle_value_changed() const override
     {
+        refresh_cache();
         emit valueChanged(static_cast<detail::value_type_t<t>>(get()));
     }
 
 private:
+    using cache_type = detail::value_cache<element_type>;
+
     t def;
+    const bool use_cache;
+    mutable cache_type cache;
+
+    t get_uncached() const
+    {
+        t val = b->contains(self_name)
+                ? static_cast<t>(b->get<element_type>(self_name))
+                : def;
+        return detail::value_get_traits<t>::get(val, def);
+    }
+
+    void refresh_cache() const
+    {
+        if (use_cache)
+            cache.store(static_cast<element_type>(get_uncached()));
+    }
 };
 
 
@@ -0,0 +1,208 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+// runs the pipeline without a GUI or camera, over a recorded track log
+// or a synthetic sine wave, and reports throughput, latency and a checksum
+// of the output poses.
+//
+// caveat: filters other than Kalman measure dt with their own clocks, so
+// their output depends on --paced and machine speed. compare checksums
+// between runs with no filter or Kalman, or with --paced on an idle machine.
+
+#include "opentrack-library-path.h"
+#include "replay.hpp"
+#include "rotation-bench.hpp"
+
+#include "logic/tracker.h"
+#include "logic/main-settings.hpp"
+#include "logic/mappings.hpp"
+#include "logic/selected-libraries.hpp"
+#include "logic/tracklogger.hpp"
+#include "api/plugin-support.hpp"
+#include "compat/timer.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QString>
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+static mem<dylib> find_module(const QList<mem<dylib>>& list, const QString& name)
+{
+    for (const mem<dylib>& lib : list)
+        if (lib->name == name)
+            return lib;
+    return nullptr;
+}
+
+static void list_modules(const char* kind, const QList<mem<dylib>>& list)
+{
+    for (const mem<dylib>& lib : list)
+        std::printf("%s: %s\n", kind, lib->name.toUtf8().constData());
+}
+
+static double percentile(const std::vector<long long>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    const std::size_t idx = std::min(sorted.size() - 1, std::size_t(sorted.size() * p));
+    return sorted[idx] * 1e-3;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser args;
+    args.setApplicationDescription("opentrack headless pipeline benchmark");
+    args.addHelpOption();
+
+    const QCommandLineOption csv_opt("csv", "Replay the raw poses of a track log.", "file");
+    const QCommandLineOption sine_opt("sine", "Replay <count> synthetic sine wave samples at 250 Hz.", "count");
+    const QCommandLineOption filter_opt("filter", "Filter module, by its displayed name.", "name");
+    const QCommandLineOption proto_opt("protocol", "Protocol module, by its displayed name.", "name");
+    const QCommandLineOption paced_opt("paced", "Sleep for the recorded dt between samples.");
+    const QCommandLineOption list_opt("list", "List available modules.");
+    const QCommandLineOption convert_opt("convert-log", "Convert a binary track log to <file>.csv and exit.", "file");
+    const QCommandLineOption rotation_opt("rotation-bench", "Time <count> 3x3 matrix products and exit.", "count");
+
+    args.addOptions({ csv_opt, sine_opt, filter_opt, proto_opt, paced_opt, list_opt, convert_opt, rotation_opt });
+    args.process(app);
+
+    if (args.isSet(rotation_opt))
+    {
+        rotation_bench(args.value(rotation_opt).toUInt());
+        return 0;
+    }
+
+    if (args.isSet(convert_opt))
+    {
+        const QString filename = args.value(convert_opt);
+        if (!TrackLoggerBinary::convert_to_csv(filename, filename + ".csv"))
+        {
+            std::fprintf(stderr, "can't convert '%s'\n", filename.toUtf8().constData());
+            return 1;
+        }
+        return 0;
+    }
+
+    Modules modules(OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH);
+
+    if (args.isSet(list_opt))
+    {
+        list_modules("filter", modules.filters());
+        list_modules("protocol", modules.protocols());
+        return 0;
+    }
+
+    std::vector<replay_sample> samples;
+
+    if (args.isSet(csv_opt))
+    {
+        const QString filename = args.value(csv_opt);
+        if (!read_csv_log(filename.toStdString(), samples))
+        {
+            std::fprintf(stderr, "can't read track log '%s'\n", filename.toUtf8().constData());
+            return 1;
+        }
+    }
+    else
+    {
+        const unsigned count = args.isSet(sine_opt) ? args.value(sine_opt).toUInt() : 100000u;
+        make_sine_samples(count, 1./250, samples);
+    }
+
+    if (samples.empty())
+    {
+        std::fprintf(stderr, "no samples to replay\n");
+        return 1;
+    }
+
+    SelectedLibraries libs;
+
+    mem<replay_tracker> tracker = std::make_shared<replay_tracker>(samples);
+    libs.pTracker = tracker;
+
+    if (args.isSet(filter_opt))
+    {
+        const QString name = args.value(filter_opt);
+        libs.pFilter = make_dylib_instance<IFilter>(find_module(modules.filters(), name));
+        if (!libs.pFilter)
+        {
+            std::fprintf(stderr, "can't load filter '%s'\n", name.toUtf8().constData());
+            return 1;
+        }
+    }
+
+    if (args.isSet(proto_opt))
+    {
+        const QString name = args.value(proto_opt);
+        libs.pProtocol = make_dylib_instance<IProtocol>(find_module(modules.protocols(), name));
+        if (!libs.pProtocol || !libs.pProtocol->correct())
+        {
+            std::fprintf(stderr, "can't load protocol '%s'\n", name.toUtf8().constData());
+            return 1;
+        }
+    }
+    else
+        libs.pProtocol = std::make_shared<null_protocol>();
+
+    libs.correct = true;
+
+    main_settings s;
+    Mappings mappings(std::vector<axis_opts*>{&s.a_x, &s.a_y, &s.a_z, &s.a_yaw, &s.a_pitch, &s.a_roll});
+    TrackLogger logger;
+
+    const bool paced = args.isSet(paced_opt);
+
+    std::vector<long long> nsecs;
+    nsecs.reserve(samples.size());
+    pose_checksum checksum;
+
+    Tracker pipeline(mappings, libs, logger);
+
+    Timer total;
+
+    while (!tracker->done())
+    {
+        if (paced)
+            std::this_thread::sleep_for(std::chrono::duration<double>(tracker->next_dt()));
+
+        Timer t;
+        pipeline.step();
+        nsecs.push_back(t.elapsed_nsecs());
+
+        double mapped[6], raw[6];
+        pipeline.get_raw_and_mapped_poses(mapped, raw);
+        checksum.add(mapped);
+    }
+
+    const double elapsed = total.elapsed_seconds();
+
+    std::sort(nsecs.begin(), nsecs.end());
+
+    std::printf("samples     %u\n", unsigned(nsecs.size()));
+    std::printf("elapsed     %.3f s\n", elapsed);
+    std::printf("throughput  %.0f poses/s\n", elapsed > 0 ? nsecs.size() / elapsed : 0.);
+    std::printf("latency us  p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+                percentile(nsecs, .5),
+                percentile(nsecs, .9),
+                percentile(nsecs, .99),
+                percentile(nsecs, .999),
+                nsecs.back() * 1e-3);
+    std::printf("checksum    %016" PRIx64 "\n", checksum.get());
+    std::printf("\n%s", pipeline.get_stats().dump().toUtf8().constData());
+
+    return 0;
+}
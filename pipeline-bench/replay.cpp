@@ -0,0 +1,134 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#include "replay.hpp"
+#include "compat/pi-constant.hpp"
+#include "compat/timer.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+bool read_csv_log(const std::string& filename, std::vector<replay_sample>& ret)
+{
+    std::ifstream in(filename);
+
+    if (!in.is_open())
+        return false;
+
+    std::string line;
+
+    // column names
+    if (!std::getline(in, line))
+        return false;
+
+    while (std::getline(in, line))
+    {
+        // dt, then raw TX..Roll. the remaining columns are pipeline output.
+        double row[7];
+        const char* ptr = line.c_str();
+        unsigned i;
+
+        for (i = 0; i < 7; i++)
+        {
+            char* end;
+            row[i] = std::strtod(ptr, &end);
+            if (end == ptr)
+                break;
+            ptr = end;
+            if (*ptr == ',')
+                ptr++;
+        }
+
+        if (i != 7)
+            continue;
+
+        replay_sample s;
+        s.dt = row[0];
+        std::memcpy(s.pose, row + 1, sizeof(s.pose));
+        ret.push_back(s);
+    }
+
+    return true;
+}
+
+void make_sine_samples(unsigned count, double dt, std::vector<replay_sample>& ret)
+{
+    static constexpr double incr[6] =
+    {
+        50, 40, 80,
+        70, 5, 3
+    };
+    static constexpr double pi = OPENTRACK_PI;
+    static constexpr double d2r = pi / 180;
+
+    double last_x[6] = { 0, 0, 0, 0, 0, 0 };
+
+    ret.reserve(ret.size() + count);
+
+    for (unsigned k = 0; k < count; k++)
+    {
+        replay_sample s;
+        s.dt = dt;
+
+        for (int i = 0; i < 6; i++)
+        {
+            const double x = std::fmod(last_x[i] + incr[i] * d2r * dt, 2 * pi);
+            last_x[i] = x;
+            s.pose[i] = std::sin(x) * (i >= 3 ? 180 : 100);
+        }
+
+        ret.push_back(s);
+    }
+}
+
+replay_tracker::replay_tracker(const std::vector<replay_sample>& samples) :
+    samples(samples),
+    pos(0),
+    timestamp(Timer::monotonic_seconds())
+{
+}
+
+void replay_tracker::data(double *data)
+{
+    if (done())
+        return;
+
+    const replay_sample& s = samples[pos++];
+    timestamp += s.dt;
+
+    for (int i = 0; i < 6; i++)
+        data[i] = s.pose[i];
+}
+
+bool replay_tracker::data_ex(double *data, sample_info& info)
+{
+    this->data(data);
+
+    info.timestamp = timestamp;
+    info.seq = pos;
+
+    return true;
+}
+
+pose_checksum::pose_checksum() : hash(14695981039346656037ull)
+{
+}
+
+void pose_checksum::add(const double* pose)
+{
+    unsigned char buf[sizeof(double) * 6];
+    std::memcpy(buf, pose, sizeof(buf));
+
+    for (unsigned i = 0; i < sizeof(buf); i++)
+    {
+        hash ^= buf[i];
+        hash *= 1099511628211ull;
+    }
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+#include "api/plugin-api.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <string>
+
+struct replay_sample
+{
+    double dt;
+    double pose[6];
+};
+
+// reads the "raw" columns of a log written by TrackLoggerCSV
+bool read_csv_log(const std::string& filename, std::vector<replay_sample>& ret);
+
+// same waveform as tracker-test, but at a fixed rate so runs are reproducible
+void make_sine_samples(unsigned count, double dt, std::vector<replay_sample>& ret);
+
+// timestamps are the recorded dt summed up, so that filters see the same
+// time steps on every run. they only track the real clock with --paced.
+class replay_tracker final : public ITracker
+{
+    const std::vector<replay_sample>& samples;
+    unsigned pos;
+    double timestamp;
+
+public:
+    replay_tracker(const std::vector<replay_sample>& samples);
+    void start_tracker(QFrame*) override {}
+    void data(double *data) override;
+    bool data_ex(double *data, sample_info& info) override;
+    bool done() const { return pos >= samples.size(); }
+    double next_dt() const { return done() ? 0 : samples[pos].dt; }
+};
+
+// used when no protocol was requested
+class null_protocol final : public IProtocol
+{
+public:
+    bool correct() override { return true; }
+    void pose(const double*) override {}
+    QString game_name() override { return QStringLiteral("pipeline-bench"); }
+};
+
+// FNV-1a over the output poses, for comparing runs
+class pose_checksum final
+{
+    std::uint64_t hash;
+
+public:
+    pose_checksum();
+    void add(const double* pose);
+    std::uint64_t get() const { return hash; }
+};
@@ -0,0 +1,69 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#include "rotation-bench.hpp"
+
+#include "logic/simple-mat.hpp"
+#include "compat/timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace euler;
+
+static rmat random_rotation(unsigned k)
+{
+    // deterministic, no need for a proper rng here
+    const double y = std::fmod(k * .37, 3), p = std::fmod(k * .11, 1.5), r = std::fmod(k * .23, 3);
+    return euler_to_rmat(euler_t(y, p, r));
+}
+
+template<typename f>
+static double time_loop(unsigned iters, const std::vector<rmat>& rs, f&& fun)
+{
+    Timer t;
+    for (unsigned i = 0; i < iters; i++)
+        fun(rs[i % rs.size()], rs[(i + 1) % rs.size()]);
+    return t.elapsed_nsecs() / double(std::max(1u, iters));
+}
+
+void rotation_bench(unsigned iters)
+{
+    std::vector<rmat> rs;
+    for (unsigned k = 0; k < 64; k++)
+        rs.push_back(random_rotation(k));
+
+    const euler_t v(10, -20, 30);
+
+    double err = 0;
+    for (unsigned k = 0; k + 1 < rs.size(); k++)
+    {
+        const rmat a = rs[k].operator*(rs[k+1]), b = rs[k] * rs[k+1];
+        const euler_t c = rs[k].operator*(v), d = rs[k] * v;
+        for (int j = 0; j < 3; j++)
+        {
+            err = std::max(err, std::fabs(c(j) - d(j)));
+            for (int i = 0; i < 3; i++)
+                err = std::max(err, std::fabs(a(j, i) - b(j, i)));
+        }
+    }
+
+    // keep the results alive so the loops don't get optimized out
+    volatile double sink = 0;
+
+    const double mm_generic = time_loop(iters, rs, [&](const rmat& a, const rmat& b) { sink = sink + a.operator*(b)(1, 1); });
+    const double mm_unrolled = time_loop(iters, rs, [&](const rmat& a, const rmat& b) { sink = sink + (a * b)(1, 1); });
+    const double mv_generic = time_loop(iters, rs, [&](const rmat& a, const rmat&) { sink = sink + a.operator*(v)(1); });
+    const double mv_unrolled = time_loop(iters, rs, [&](const rmat& a, const rmat&) { sink = sink + (a * v)(1); });
+
+    std::printf("3x3 * 3x3   generic %.2f ns  unrolled %.2f ns\n", mm_generic, mm_unrolled);
+    std::printf("3x3 * 3x1   generic %.2f ns  unrolled %.2f ns\n", mv_generic, mv_unrolled);
+    std::printf("max error   %g\n", err);
+}
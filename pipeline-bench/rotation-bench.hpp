@@ -0,0 +1,13 @@
+/* Copyright (c) 2026, agent <agent@local>
+
+ * Permission to use, copy, modify, and/or distribute this
+ * software for any purpose with or without fee is hereby granted,
+ * provided that the above copyright notice and this permission
+ * notice appear in all copies.
+ */
+
+#pragma once
+
+// times the generic Mat product against the unrolled 3x3 kernels
+// and prints the largest difference between their results.
+void rotation_bench(unsigned iters);
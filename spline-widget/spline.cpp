@@ -10,7 +10,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <memory>
+#include <thread>
 
 #include <QObject>
 #include <QMutexLocker>
@@ -25,8 +27,10 @@ constexpr int spline::value_count;
 
 spline::spline(qreal maxx, qreal maxy, const QString& name) :
     s(nullptr),
-    data(value_count, -1.f),
+    snapshot(nullptr),
+    snapshot_readers(0u),
     _mutex(QMutex::Recursive),
+    last_input_value(0u),
     max_x(maxx),
     max_y(maxy),
     activep(false)
@@ -34,6 +38,19 @@ spline::spline(qreal maxx, qreal maxy, const QString& name) :
     set_bundle(options::make_bundle(name));
 }
 
+spline::spline(const spline& other) :
+    s(nullptr),
+    snapshot(nullptr),
+    snapshot_readers(0u),
+    _mutex(QMutex::Recursive),
+    last_input_value(0u),
+    max_x(other.maxInput()),
+    max_y(other.maxOutput()),
+    activep(false)
+{
+    set_bundle(other.get_settings()->b);
+}
+
 spline::~spline()
 {
     QMutexLocker l(&_mutex);
@@ -42,6 +59,8 @@ spline::~spline()
     {
         QObject::disconnect(connection);
     }
+
+    publish_snapshot(nullptr);
 }
 
 spline::spline() : spline(0, 0, "")
@@ -93,34 +112,62 @@ qreal spline::maxOutput() const
 
 float spline::getValue(double x)
 {
-    QMutexLocker foo(&_mutex);
-    float q  = float(x * precision(s->points));
+    snapshot_readers.fetch_add(1u);
+    const interp_snapshot& snap = *snapshot.load();
+    float q  = float(x * snap.precision);
     int    xi = (int)q;
-    float  yi = getValueInternal(xi);
-    float  yiplus1 = getValueInternal(xi+1);
+    float  yi = getValueInternal(snap, xi);
+    float  yiplus1 = getValueInternal(snap, xi+1);
+    snapshot_readers.fetch_sub(1u);
     float  f = (q-xi);
     float  ret = yiplus1 * f + yi * (1.0f - f); // at least do a linear interpolation.
-    last_input_value.setX(std::fabs(x));
-    last_input_value.setY(double(std::fabs(ret)));
+    last_input_value.store(pack_point(float(std::fabs(x)), std::fabs(ret)), std::memory_order_relaxed);
     return ret;
 }
 
 bool spline::getLastPoint(QPointF& point )
 {
-    QMutexLocker foo(&_mutex);
-    point = last_input_value;
+    point = unpack_point(last_input_value.load(std::memory_order_relaxed));
     return activep;
 }
 
-float spline::getValueInternal(int x)
+float spline::getValueInternal(const interp_snapshot& snap, int x)
 {
     float sign = x < 0 ? -1 : 1;
     x = abs(x);
     float ret;
-        ret = data[std::min(unsigned(x), unsigned(value_count)-1u)];
+        ret = snap.data[std::min(unsigned(x), unsigned(value_count)-1u)];
     return ret * sign;
 }
 
+void spline::publish_snapshot(const interp_snapshot* snap)
+{
+    const interp_snapshot* old = snapshot.exchange(snap);
+
+    // readers that got the old table are a few loads away from being done with it
+    while (snapshot_readers.load() != 0u)
+        std::this_thread::yield();
+
+    delete old;
+}
+
+std::uint64_t spline::pack_point(float x, float y)
+{
+    std::uint32_t x_, y_;
+    std::memcpy(&x_, &x, sizeof(x_));
+    std::memcpy(&y_, &y, sizeof(y_));
+    return std::uint64_t(x_) << 32 | y_;
+}
+
+QPointF spline::unpack_point(std::uint64_t val)
+{
+    const std::uint32_t x_ = std::uint32_t(val >> 32), y_ = std::uint32_t(val);
+    float x, y;
+    std::memcpy(&x, &x_, sizeof(x));
+    std::memcpy(&y, &y_, sizeof(y));
+    return QPointF(double(x), double(y));
+}
+
 void spline::add_lone_point()
 {
     points_t points;
@@ -157,8 +204,10 @@ void spline::update_interp_data()
     const double mult = precision(points);
     const double mult_ = mult * 30;
 
-    for (unsigned i = 0; i < value_count; i++)
-        data[i] = -1;
+    interp_snapshot* snap = new interp_snapshot;
+    snap->precision = precision(s->points);
+    std::vector<float>& data = snap->data;
+    data.resize(value_count, -1.f);
 
     if (points.size() == 1)
     {
@@ -220,6 +269,8 @@ void spline::update_interp_data()
             data[i] = last;
         last = data[i];
     }
+
+    publish_snapshot(snap);
 }
 
 void spline::removePoint(int i)
@@ -372,7 +423,7 @@ void spline::recompute()
     if (ret_list != s->points)
         s->points = ret_list;
 
-    last_input_value = QPointF(0, 0);
+    last_input_value.store(pack_point(0, 0), std::memory_order_relaxed);
     activep = false;
 
     update_interp_data();
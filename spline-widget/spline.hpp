@@ -18,6 +18,8 @@ using namespace options;
 #include <vector>
 #include <limits>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 
 #include <QObject>
 #include <QPointF>
@@ -41,9 +43,17 @@ signals:
 
 class OPENTRACK_SPLINE_EXPORT spline final
 {
+    // immutable once published, replaced as a whole when the curve changes
+    struct interp_snapshot
+    {
+        std::vector<float> data;
+        double precision;
+    };
+
     double precision(const QList<QPointF>& points) const;
     void update_interp_data();
-    float getValueInternal(int x);
+    void publish_snapshot(const interp_snapshot* snap);
+    static float getValueInternal(const interp_snapshot& snap, int x);
     void add_lone_point();
     static bool sort_fn(const QPointF& one, const QPointF& two);
 
@@ -52,16 +62,21 @@ class OPENTRACK_SPLINE_EXPORT spline final
     mem<spline_detail::settings> s;
     QMetaObject::Connection connection;
 
-    std::vector<float> data;
-    using interp_data_t = decltype(data);
+    // getValue() runs on the pipeline thread and never takes the mutex
+    std::atomic<const interp_snapshot*> snapshot;
+    std::atomic<unsigned> snapshot_readers;
 
     static constexpr int value_count = 10000;
 
     MyMutex _mutex;
-    QPointF last_input_value;
+    // packed pair of floats for the widget cursor
+    std::atomic<std::uint64_t> last_input_value;
     qreal max_x, max_y;
     volatile bool activep;
 
+    static std::uint64_t pack_point(float x, float y);
+    static QPointF unpack_point(std::uint64_t val);
+
 public:
     using settings = spline_detail::settings;
 
@@ -76,8 +91,9 @@ public:
     spline(qreal maxx, qreal maxy, const QString& name);
     ~spline();
 
-    spline& operator=(const spline&) = default;
-    spline(const spline&) = default;
+    spline& operator=(const spline&) = delete;
+    // shares the other spline's bundle
+    spline(const spline& other);
 
     float getValue(double x);
     bool getLastPoint(QPointF& point);
@@ -11,11 +11,14 @@
 #include <opencv2/videoio.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/calib3d.hpp>
+#include <opencv2/video.hpp>
 #include "compat/camera-names.hpp"
 #include "compat/sleep.hpp"
 #include "compat/pi-constant.hpp"
+#include "compat/timer.hpp"
 
 #include <QMutexLocker>
+#include <QFileDialog>
 #include <QDebug>
 
 #include <vector>
@@ -42,12 +45,23 @@ Tracker::Tracker() :
     stop(false),
     layout(nullptr),
     videoWidget(nullptr),
-    obj_points(4),
+    frame_time(0),
+    sample { 0, 0 },
+    board_center(0, 0, 0),
     intrinsics(decltype(intrinsics)::eye()),
+    intrinsics_w(-1),
+    intrinsics_h(-1),
+    intrinsics_fov(-1),
     dist_coeffs(decltype(dist_coeffs)::zeros()),
     rmat(decltype(rmat)::eye()),
-    roi_points(4),
     last_roi(65535, 65535, 0, 0),
+    centroid_valid(false),
+    frames_since_detect(0),
+    corners_from_flow(false),
+    detect_ms(0),
+    frame_ms(0),
+    recovery_ms(-1),
+    lost_since(-1),
     freq(cv::getTickFrequency()), // XXX change to timer.hpp
     cur_fps(0)
 {
@@ -68,6 +82,9 @@ Tracker::~Tracker()
     // fast start/stop causes breakage
     portable::sleep(1000);
     camera.release();
+#ifdef __linux
+    native_camera.close();
+#endif
 }
 
 void Tracker::start_tracker(QFrame* videoframe)
@@ -109,15 +126,14 @@ bool Tracker::detect_with_roi()
 
         detector.detect(grayscale_, markers, cv::Mat(), cv::Mat(), -1, false);
 
-        if (markers.size() == 1 && markers[0].size() == 4)
+        if (accept_markers())
         {
-            auto& m = markers[0];
-            for (unsigned i = 0; i < 4; i++)
-            {
-                auto& p = m[i];
-                p.x += last_roi.x;
-                p.y += last_roi.y;
-            }
+            for (auto& m : markers)
+                for (auto& p : m)
+                {
+                    p.x += last_roi.x;
+                    p.y += last_roi.y;
+                }
             return true;
         }
     }
@@ -129,8 +145,190 @@ bool Tracker::detect_with_roi()
 bool Tracker::detect_without_roi()
 {
     detector.setMinMaxSize(size_min, size_max);
+
+    // coarse to fine. min/max size are relative to the image width, so they
+    // stay the same on smaller pyramid levels.
+    int levels = 0;
+    const cv::Mat* img = &grayscale;
+
+    while (levels < pyramid_levels && (img->cols >> 1) >= pyramid_min_width)
+    {
+        cv::pyrDown(*img, pyramid[levels]);
+        img = &pyramid[levels];
+        levels++;
+    }
+
+    if (levels > 0)
+    {
+        detector.detect(*img, markers, cv::Mat(), cv::Mat(), -1, false);
+
+        if (accept_markers())
+        {
+            const int scale = 1 << levels;
+            const float off = (scale - 1) * .5f;
+            // corners are off by up to a coarse pixel
+            const int win = 2 * scale + 1;
+
+            for (auto& m : markers)
+            {
+                for (cv::Point2f& p : m)
+                    p = p * float(scale) + cv::Point2f(off, off);
+
+                cv::cornerSubPix(grayscale, m, cv::Size(win, win), cv::Size(-1, -1),
+                                 cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 10, .01));
+            }
+            return true;
+        }
+
+        // too small to see on the coarse level
+        markers.clear();
+    }
+
     detector.detect(grayscale, markers, cv::Mat(), cv::Mat(), -1, false);
-    return markers.size() == 1 && markers[0].size() == 4;
+    return accept_markers();
+}
+
+bool Tracker::accept_markers()
+{
+    if (board.empty())
+        return markers.size() == 1 && markers[0].size() == 4;
+
+    // anything not on the board isn't ours
+    markers.erase(std::remove_if(markers.begin(), markers.end(),
+                                 [this](const aruco::Marker& m) {
+                                     return m.size() != 4 || board.getIndexOfMarkerId(m.id) < 0;
+                                 }),
+                  markers.end());
+
+    return !markers.empty();
+}
+
+void Tracker::load_board()
+{
+    board.clear();
+    board_points.clear();
+    board_center = cv::Point3f(0, 0, 0);
+
+    const QString filename = s.board_file;
+
+    if (filename.isEmpty())
+        return;
+
+    try
+    {
+        board.readFromFile(filename.toStdString());
+    }
+    catch (const cv::Exception& e)
+    {
+        qDebug() << "aruco tracker: can't read board" << filename << e.what();
+        board.clear();
+        return;
+    }
+
+    for (const aruco::MarkerInfo& info : board)
+        if (info.size() != 4)
+        {
+            qDebug() << "aruco tracker: board marker" << info.id << "doesn't have 4 corners";
+            board.clear();
+            return;
+        }
+
+    if (board.empty())
+        return;
+
+    // to millimeters. boards made in pixels get the single marker's size.
+    float scale = 1000;
+    if (board.isExpressedInPixels())
+        scale = marker_size / float(cv::norm(board[0][0] - board[0][1]));
+
+    for (aruco::MarkerInfo& info : board)
+        for (cv::Point3f& p : info)
+        {
+            p *= scale;
+            board_points.push_back(p);
+            board_center += p;
+        }
+
+    board_center *= 1.f / board_points.size();
+
+    qDebug() << "aruco tracker: board with" << board.size() << "markers";
+}
+
+bool Tracker::detect_marker()
+{
+    markers.clear();
+
+    if (!detect_with_roi() && !detect_without_roi())
+        return false;
+
+    if (s.corner_subpix)
+        refine_corners();
+
+    frames_since_detect = 0;
+
+    return true;
+}
+
+bool Tracker::track_corners()
+{
+    if (prev_markers.empty() ||
+        frames_since_detect >= int(s.redetect_interval) ||
+        prev_grayscale.size() != grayscale.size())
+        return false;
+
+    prev_corners.clear();
+    for (const auto& m : prev_markers)
+        prev_corners.insert(prev_corners.end(), m.begin(), m.end());
+
+    cv::calcOpticalFlowPyrLK(prev_grayscale, grayscale, prev_corners, flow_corners, flow_status, flow_error,
+                             cv::Size(15, 15), 2,
+                             cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, .03));
+
+    for (unsigned i = 0; i < prev_corners.size(); i++)
+    {
+        const cv::Point2f& p = flow_corners[i];
+
+        if (!flow_status[i] || p.x < 0 || p.y < 0 || p.x >= grayscale.cols || p.y >= grayscale.rows)
+            return false;
+
+        // head motion doesn't change a side's length this much between
+        // frames, one of its corners slipped
+        const unsigned j = i / 4 * 4 + (i + 1) % 4;
+        const double before = cv::norm(prev_corners[i] - prev_corners[j]);
+        const double after = cv::norm(flow_corners[i] - flow_corners[j]);
+
+        if (after < before * .8 || after > before * 1.25)
+            return false;
+    }
+
+    // keeps the ids
+    markers = prev_markers;
+    for (unsigned k = 0; k < markers.size(); k++)
+        for (unsigned i = 0; i < 4; i++)
+            markers[k][i] = flow_corners[k * 4 + i];
+
+    if (s.corner_subpix)
+        refine_corners();
+
+    frames_since_detect++;
+
+    return true;
+}
+
+void Tracker::refine_corners()
+{
+    for (auto& m_ : markers)
+    {
+        std::vector<cv::Point2f>& m = m_;
+
+        // the marker's black border is a seventh of its side, stay within it
+        const double side = (cv::norm(m[0] - m[1]) + cv::norm(m[1] - m[2]) +
+                             cv::norm(m[2] - m[3]) + cv::norm(m[3] - m[0])) * .25;
+        const int win = std::max(2, std::min(5, int(side / 14)));
+
+        cv::cornerSubPix(grayscale, m, cv::Size(win, win), cv::Size(-1, -1),
+                         cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, .01));
+    }
 }
 
 bool Tracker::open_camera()
@@ -165,6 +363,19 @@ bool Tracker::open_camera()
 
     QMutexLocker l(&camera_mtx);
 
+#ifdef __linux
+    // asks for the same 640x480 as opencv does when resolution isn't forced
+    if (s.native_capture)
+    {
+        if (native_camera.open(camera_name_to_index(s.camera_name),
+                               res.width ? res.width : 640,
+                               res.height ? res.height : 480,
+                               fps))
+            return true;
+        qDebug() << "aruco tracker: no native capture, using opencv";
+    }
+#endif
+
     camera = cv::VideoCapture(camera_name_to_index(s.camera_name));
     if (res.width)
     {
@@ -182,11 +393,55 @@ bool Tracker::open_camera()
     return true;
 }
 
+bool Tracker::read_frame()
+{
+    QMutexLocker l(&camera_mtx);
+
+#ifdef __linux
+    if (native_camera.is_open())
+        return native_camera.read(grayscale, frame_time, 500);
+#endif
+
+    if (!camera.read(color))
+        return false;
+
+    // opencv doesn't expose the driver's timestamp
+    frame_time = Timer::monotonic_seconds();
+
+    cv::cvtColor(color, grayscale, cv::COLOR_RGB2GRAY);
+
+    return true;
+}
+
+void Tracker::set_overlay_frame()
+{
+#ifdef __linux
+    // native capture gives grayscale, the overlay still wants color
+    if (native_camera.is_open())
+    {
+        cv::cvtColor(grayscale, frame, cv::COLOR_GRAY2BGR);
+        return;
+    }
+#endif
+
+    // no copy, the next read overwrites it after the widget took its own
+    frame = color;
+}
+
 void Tracker::set_intrinsics()
 {
     static constexpr double pi = OPENTRACK_PI;
     const int w = grayscale.cols, h = grayscale.rows;
-    const double diag_fov = static_cast<int>(s.fov) * pi / 180.;
+    const int fov = s.fov;
+
+    if (w == intrinsics_w && h == intrinsics_h && fov == intrinsics_fov)
+        return;
+
+    intrinsics_w = w;
+    intrinsics_h = h;
+    intrinsics_fov = fov;
+
+    const double diag_fov = fov * pi / 180.;
     const double fov_w = 2.*atan(tan(diag_fov/2.)/sqrt(1. + h/(double)w * h/(double)w));
     const double fov_h = 2.*atan(tan(diag_fov/2.)/sqrt(1. + w/(double)h * w/(double)h));
     const double focal_length_w = .5 * w / tan(.5 * fov_w);
@@ -198,6 +453,38 @@ void Tracker::set_intrinsics()
     intrinsics(1, 2) = grayscale.rows/2;
 }
 
+double Tracker::reprojection_error()
+{
+    cv::projectPoints(obj_points, rvec, tvec, intrinsics, dist_coeffs, repr2);
+
+    double sum = 0;
+    for (unsigned i = 0; i < img_points.size(); i++)
+    {
+        const cv::Point2f d = repr2[i] - img_points[i];
+        sum += double(d.dot(d));
+    }
+
+    return std::sqrt(sum / img_points.size());
+}
+
+bool Tracker::solve_pose(bool warm)
+{
+    // while tracking, last frame's pose is close enough for the iterative
+    // solver alone. DLS only runs to (re)acquire or when that goes wrong.
+    if (warm &&
+        cv::solvePnP(obj_points, img_points, intrinsics, dist_coeffs, rvec, tvec, true, cv::SOLVEPNP_ITERATIVE) &&
+        tvec[2] > 0 &&
+        reprojection_error() < max_warm_error)
+    {
+        return true;
+    }
+
+    if (!cv::solvePnP(obj_points, img_points, intrinsics, dist_coeffs, rvec, tvec, false, cv::SOLVEPNP_DLS))
+        return false;
+
+    return cv::solvePnP(obj_points, img_points, intrinsics, dist_coeffs, rvec, tvec, true, cv::SOLVEPNP_ITERATIVE);
+}
+
 void Tracker::update_fps(double alpha)
 {
     std::uint64_t time = std::uint64_t(cv::getTickCount());
@@ -210,16 +497,60 @@ void Tracker::update_fps(double alpha)
 void Tracker::draw_ar(bool ok)
 {
     if (ok)
-    {
-        const auto& m = markers[0];
-        for (unsigned i = 0; i < 4; i++)
-            cv::line(frame, m[i], m[(i+1)%4], cv::Scalar(0, 0, 255), 2, 8);
-    }
+        for (const auto& m : markers)
+            for (unsigned i = 0; i < 4; i++)
+                cv::line(frame, m[i], m[(i+1)%4], cv::Scalar(0, 0, 255), 2, 8);
 
     char buf[32];
     ::snprintf(buf, sizeof(buf)-1, "Hz: %d", (int)(unsigned short)cur_fps);
     buf[sizeof(buf)-1] = '\0';
     cv::putText(frame, buf, cv::Point(10, 32), cv::FONT_HERSHEY_PLAIN, 2, cv::Scalar(0, 255, 0), 1);
+
+    ::snprintf(buf, sizeof(buf)-1, "detect: %.1f ms%s", detect_ms, corners_from_flow ? " flow" : "");
+    buf[sizeof(buf)-1] = '\0';
+    cv::putText(frame, buf, cv::Point(10, 60), cv::FONT_HERSHEY_PLAIN, 1.5, cv::Scalar(0, 255, 0), 1);
+
+    ::snprintf(buf, sizeof(buf)-1, "frame: %.1f ms", frame_ms);
+    buf[sizeof(buf)-1] = '\0';
+    cv::putText(frame, buf, cv::Point(10, 84), cv::FONT_HERSHEY_PLAIN, 1.5, cv::Scalar(0, 255, 0), 1);
+
+    if (recovery_ms >= 0)
+    {
+        ::snprintf(buf, sizeof(buf)-1, "recovery: %d ms", int(recovery_ms));
+        buf[sizeof(buf)-1] = '\0';
+        cv::putText(frame, buf, cv::Point(10, 108), cv::FONT_HERSHEY_PLAIN, 1.5, cv::Scalar(0, 255, 0), 1);
+    }
+}
+
+void Tracker::update_motion()
+{
+    cv::Point2f c(0, 0);
+    for (const cv::Point2f& p : img_points)
+        c += p;
+    c *= 1.f / img_points.size();
+
+    if (centroid_valid)
+        centroid_step = centroid_step * .5f + (c - last_centroid) * .5f;
+    else
+        centroid_step = cv::Point2f(0, 0);
+
+    last_centroid = c;
+    centroid_valid = true;
+}
+
+void Tracker::update_recovery(bool tracked)
+{
+    if (!tracked)
+    {
+        centroid_valid = false;
+        if (lost_since < 0)
+            lost_since = frame_time;
+    }
+    else if (lost_since >= 0)
+    {
+        recovery_ms = std::max(0., (frame_time - lost_since) * 1e3);
+        lost_since = -1;
+    }
 }
 
 void Tracker::clamp_last_roi()
@@ -232,14 +563,14 @@ void Tracker::clamp_last_roi()
         last_roi.width = 1;
     if (last_roi.height < 1)
         last_roi.height = 1;
-    if (last_roi.x >= color.cols-1)
-        last_roi.x = color.cols-1;
-    if (last_roi.width >= color.cols-1)
-        last_roi.width = color.cols-1;
-    if (last_roi.y >= color.rows-1)
-        last_roi.y = color.rows-1;
-    if (last_roi.height >= color.rows-1)
-        last_roi.height = color.rows-1;
+    if (last_roi.x >= grayscale.cols-1)
+        last_roi.x = grayscale.cols-1;
+    if (last_roi.width >= grayscale.cols-1)
+        last_roi.width = grayscale.cols-1;
+    if (last_roi.y >= grayscale.rows-1)
+        last_roi.y = grayscale.rows-1;
+    if (last_roi.height >= grayscale.rows-1)
+        last_roi.height = grayscale.rows-1;
 
     last_roi.width -= last_roi.x;
     last_roi.height -= last_roi.y;
@@ -248,16 +579,35 @@ void Tracker::clamp_last_roi()
 void Tracker::set_points()
 {
     using f = float;
-    const f hx = f(s.headpos_x), hy = f(s.headpos_y), hz = f(s.headpos_z);
+    const cv::Point3f h(f(s.headpos_x), f(s.headpos_y), f(s.headpos_z));
 
-    static constexpr float size = 40;
+    obj_points.clear();
+    img_points.clear();
 
-    const int x1=1, x2=2, x3=3, x4=0;
+    if (board.empty())
+    {
+        const float size = marker_size * .5f;
 
-    obj_points[x1] = cv::Point3f(-size + hx, -size + hy, 0 + hz);
-    obj_points[x2] = cv::Point3f(size + hx, -size + hy, 0 + hz);
-    obj_points[x3] = cv::Point3f(size + hx, size + hy, 0 + hz);
-    obj_points[x4] = cv::Point3f(-size + hx, size + hy, 0 + hz);
+        obj_points.push_back(cv::Point3f(-size, size, 0) + h);
+        obj_points.push_back(cv::Point3f(-size, -size, 0) + h);
+        obj_points.push_back(cv::Point3f(size, -size, 0) + h);
+        obj_points.push_back(cv::Point3f(size, size, 0) + h);
+
+        img_points = markers[0];
+        return;
+    }
+
+    // one joint solve over every visible marker on the board
+    for (const aruco::Marker& m : markers)
+    {
+        const aruco::MarkerInfo& info = board[board.getIndexOfMarkerId(m.id)];
+
+        for (unsigned i = 0; i < 4; i++)
+        {
+            obj_points.push_back(info[i] + h);
+            img_points.push_back(m[i]);
+        }
+    }
 }
 
 void Tracker::draw_centroid()
@@ -275,18 +625,30 @@ void Tracker::draw_centroid()
 void Tracker::set_last_roi()
 {
     roi_projection.clear();
+    roi_points.clear();
 
     using f = float;
-    cv::Point3f h(f(s.headpos_x), f(s.headpos_y), f(s.headpos_z));
-    for (unsigned i = 0; i < 4; i++)
-    {
-        cv::Point3f pt(obj_points[i] - h);
-        roi_points[i] = pt * c_search_window;
-    }
+    const cv::Point3f h(f(s.headpos_x), f(s.headpos_y), f(s.headpos_z));
+
+    // the whole board, so that markers hidden on this frame are searched, too
+    if (board.empty())
+        for (unsigned i = 0; i < 4; i++)
+            roi_points.push_back((obj_points[i] - h) * c_search_window + h);
+    else
+        for (const cv::Point3f& p : board_points)
+            roi_points.push_back((p - board_center) * c_search_window + board_center + h);
 
     cv::projectPoints(roi_points, rvec, tvec, intrinsics, dist_coeffs, roi_projection);
 
     set_roi_from_projection();
+
+    // cover where the marker is going to be on the next frame, too
+    if (centroid_valid)
+    {
+        const cv::Point step(cvRound(centroid_step.x), cvRound(centroid_step.y));
+        last_roi |= last_roi + step;
+        last_roi &= cv::Rect(0, 0, grayscale.cols, grayscale.rows);
+    }
 }
 
 void Tracker::set_rmat()
@@ -304,15 +666,18 @@ void Tracker::set_rmat()
     pose[Pitch] = -euler[0];
     pose[Roll] = euler[2];
 
+    sample.timestamp = frame_time;
+    sample.seq++;
+
     r = rmat;
     t = cv::Vec3d(tvec[0], -tvec[1], tvec[2]);
 }
 
 void Tracker::set_roi_from_projection()
 {
-    last_roi = cv::Rect(color.cols-1, color.rows-1, 0, 0);
+    last_roi = cv::Rect(grayscale.cols-1, grayscale.rows-1, 0, 0);
 
-    for (unsigned i = 0; i < 4; i++)
+    for (unsigned i = 0; i < roi_projection.size(); i++)
     {
         const auto& proj = roi_projection[i];
         int min_x = std::min(int(proj.x), last_roi.x),
@@ -343,52 +708,96 @@ void Tracker::run()
     if (!open_camera())
         return;
 
+    load_board();
+
     last_time = std::uint64_t(cv::getTickCount());
 
     while (!stop)
     {
-        {
-            QMutexLocker l(&camera_mtx);
-
-            if (!camera.read(color))
-                continue;
-        }
-
-        cv::cvtColor(color, grayscale, cv::COLOR_RGB2GRAY);
+        if (!read_frame())
+            continue;
 
-        color.copyTo(frame);
+        // what the frame costs us, not the wait for the camera
+        Timer loop_timer;
 
         set_intrinsics();
 
         update_fps(alpha_);
 
-        markers.clear();
+        // previous frame had a pose
+        const bool warm = centroid_valid;
+
+        Timer detect_time;
+        bool flow = s.corner_tracking && track_corners();
+        bool ok = flow || detect_marker();
+        detect_ms = detect_time.elapsed_usecs() * 1e-3;
 
-        const bool ok = detect_with_roi() || detect_without_roi();
+        bool tracked = false;
 
         if (ok)
         {
             set_points();
 
-            if (!cv::solvePnP(obj_points, markers[0], intrinsics, dist_coeffs, rvec, tvec, false, cv::SOLVEPNP_DLS))
-                goto fail;
+            tracked = solve_pose(warm);
 
-            if (!cv::solvePnP(obj_points, markers[0], intrinsics, dist_coeffs, rvec, tvec, true, cv::SOLVEPNP_ITERATIVE))
-                goto fail;
+            // the corners drifted, decode the marker after all
+            if (flow && !(tracked && reprojection_error() < max_warm_error))
+            {
+                flow = false;
+                detect_time.start();
+                ok = detect_marker();
+                detect_ms += detect_time.elapsed_usecs() * 1e-3;
+                tracked = false;
+
+                if (ok)
+                {
+                    // markers and corners differ from the flow's
+                    set_points();
+                    tracked = solve_pose(false) && reprojection_error() < max_warm_error;
+                }
+            }
 
-            set_last_roi();
-            draw_centroid();
-            set_rmat();
+            if (tracked)
+            {
+                set_rmat();
+                notify_new_data();
+
+                update_motion();
+                set_last_roi();
+            }
         }
-        else
-fail:
+
+        corners_from_flow = flow;
+
+        if (!tracked)
             // no marker found, reset search region
             last_roi = cv::Rect(65535, 65535, 0, 0);
 
-        draw_ar(ok);
+        update_recovery(tracked);
+
+        if (tracked && s.corner_tracking)
+            prev_markers = markers;
+        else
+            prev_markers.clear();
+
+        // only draw what the widget is going to show
+        if (videoWidget->wants_frame())
+        {
+            set_overlay_frame();
+
+            if (tracked)
+                draw_centroid();
+            draw_ar(ok);
+
+            if (frame.rows > 0)
+                videoWidget->update_image(frame);
+        }
+
+        // the next frame gets read into the old buffer
+        if (s.corner_tracking)
+            cv::swap(prev_grayscale, grayscale);
 
-        if (frame.rows > 0)
-            videoWidget->update_image(frame);
+        frame_ms = loop_timer.elapsed_usecs() * 1e-3;
     }
 
     // give opencv time to exit camera threads, etc.
@@ -407,6 +816,25 @@ void Tracker::data(double *data)
     data[TZ] = pose[TZ];
 }
 
+bool Tracker::data_ex(double *data, sample_info& info)
+{
+    QMutexLocker lck(&mtx);
+
+    if (sample.seq == 0)
+        return false;
+
+    data[Yaw] = pose[Yaw];
+    data[Pitch] = pose[Pitch];
+    data[Roll] = pose[Roll];
+    data[TX] = pose[TX] * .5;
+    data[TY] = pose[TY] * .5;
+    data[TZ] = pose[TZ];
+
+    info = sample;
+
+    return true;
+}
+
 TrackerControls::TrackerControls()
 {
     tracker = nullptr;
@@ -417,6 +845,15 @@ TrackerControls::TrackerControls()
     tie_setting(s.camera_name, ui.cameraName);
     tie_setting(s.resolution, ui.resolution);
     tie_setting(s.force_fps, ui.cameraFPS);
+    tie_setting(s.native_capture, ui.native_capture);
+#ifndef __linux
+    ui.native_capture->setVisible(false);
+    ui.label_native_capture->setVisible(false);
+#endif
+    tie_setting(s.corner_subpix, ui.corner_subpix);
+    tie_setting(s.corner_tracking, ui.corner_tracking);
+    tie_setting(s.redetect_interval, ui.redetect_interval);
+    tie_setting(s.board_file, ui.board_file);
     tie_setting(s.fov, ui.cameraFOV);
     tie_setting(s.headpos_x, ui.cx);
     tie_setting(s.headpos_y, ui.cy);
@@ -424,10 +861,20 @@ TrackerControls::TrackerControls()
     connect(ui.buttonBox, SIGNAL(accepted()), this, SLOT(doOK()));
     connect(ui.buttonBox, SIGNAL(rejected()), this, SLOT(doCancel()));
     connect(ui.btn_calibrate, SIGNAL(clicked()), this, SLOT(toggleCalibrate()));
+    connect(ui.board_browse, SIGNAL(clicked()), this, SLOT(browse_board()));
     connect(this, SIGNAL(destroyed()), this, SLOT(cleanupCalib()));
     connect(&calib_timer, SIGNAL(timeout()), this, SLOT(update_tracker_calibration()));
 }
 
+void TrackerControls::browse_board()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Marker board"),
+                                                    ui.board_file->text(),
+                                                    tr("Board configuration (*.yml);;All Files (*)"));
+    if (!filename.isEmpty())
+        s.board_file = filename;
+}
+
 void TrackerControls::toggleCalibrate()
 {
     if (!calib_timer.isActive())
@@ -10,9 +10,11 @@
 #include "ui_aruco-trackercontrols.h"
 #include "api/plugin-api.hpp"
 #include "include/markerdetector.h"
+#include "include/board.h"
 
 #include "cv/video-widget.hpp"
 #include "cv/translation-calibrator.hpp"
+#include "cv/v4l2-capture.hpp"
 
 #include <opencv2/core.hpp>
 #include <opencv2/videoio.hpp>
@@ -32,8 +34,10 @@ using namespace options;
 struct settings : opts {
     value<int> fov;
     value<double> headpos_x, headpos_y, headpos_z;
-    value<QString> camera_name;
+    value<QString> camera_name, board_file;
     value<int> force_fps, resolution;
+    value<bool> native_capture, corner_subpix, corner_tracking;
+    value<int> redetect_interval;
     settings() :
         opts("aruco-tracker"),
         fov(b, "field-of-view", 56),
@@ -41,8 +45,13 @@ struct settings : opts {
         headpos_y(b, "headpos-y", 0),
         headpos_z(b, "headpos-z", 0),
         camera_name(b, "camera-name", ""),
+        board_file(b, "board-config", ""),
         force_fps(b, "force-fps", 0),
-        resolution(b, "force-resolution", 0)
+        resolution(b, "force-resolution", 0),
+        native_capture(b, "native-capture", false),
+        corner_subpix(b, "corner-subpixel", false),
+        corner_tracking(b, "corner-tracking", false),
+        redetect_interval(b, "redetect-interval", 10)
     {}
 };
 
@@ -53,18 +62,37 @@ class Tracker : protected QThread, public ITracker
     Q_OBJECT
     friend class TrackerControls;
     static constexpr float c_search_window = 1.3f;
+    // coarse search doesn't go below this width
+    static constexpr int pyramid_min_width = 320;
+    static constexpr int pyramid_levels = 2;
+    // millimeters, side of the single marker
+    static constexpr float marker_size = 80;
+    // pixels, rms over the corners. above it, the warm-started solution
+    // is thrown away and the pose solved from scratch.
+    static constexpr double max_warm_error = 3;
 public:
     Tracker();
     ~Tracker() override;
     void start_tracker(QFrame* frame) override;
     void data(double *data) override;
+    bool data_ex(double *data, sample_info& info) override;
+    bool is_event_driven() override { return true; }
     void run() override;
     void getRT(cv::Matx33d &r, cv::Vec3d &t);
 private:
     bool detect_with_roi();
     bool detect_without_roi();
+    bool detect_marker();
+    bool accept_markers();
+    void load_board();
+    bool track_corners();
+    void refine_corners();
     bool open_camera();
+    bool read_frame();
+    void set_overlay_frame();
     void set_intrinsics();
+    bool solve_pose(bool warm);
+    double reprojection_error();
     void update_fps(double dt);
     void draw_ar(bool ok);
     void clamp_last_roi();
@@ -73,8 +101,13 @@ private:
     void set_last_roi();
     void set_rmat();
     void set_roi_from_projection();
+    void update_motion();
+    void update_recovery(bool tracked);
 
     cv::VideoCapture camera;
+#ifdef __linux
+    v4l2_capture native_camera;
+#endif
     QMutex camera_mtx;
     QMutex mtx;
     volatile bool stop;
@@ -82,10 +115,21 @@ private:
     cv_video_widget* videoWidget;
     settings s;
     double pose[6];
+    // capture time of the current frame, and of the pose in `pose'
+    double frame_time;
+    sample_info sample;
     cv::Mat frame, grayscale, color;
     cv::Matx33d r;
+    // corners of the visible markers, and where they are in the image
     std::vector<cv::Point3f> obj_points;
+    std::vector<cv::Point2f> img_points;
+    // empty unless a board is configured. corners in millimeters.
+    aruco::BoardConfiguration board;
+    std::vector<cv::Point3f> board_points;
+    cv::Point3f board_center;
     cv::Matx33d intrinsics;
+    // what the intrinsics were computed for
+    int intrinsics_w, intrinsics_h, intrinsics_fov;
     cv::Matx14f dist_coeffs;
     aruco::MarkerDetector detector;
     std::vector<aruco::Marker> markers;
@@ -97,6 +141,23 @@ private:
     cv::Vec3d euler;
     std::vector<cv::Point3f> roi_points;
     cv::Rect last_roi;
+    // marker centroid and its smoothed displacement per frame, to move the
+    // search region ahead of the marker
+    cv::Point2f last_centroid, centroid_step;
+    bool centroid_valid;
+    cv::Mat pyramid[pyramid_levels];
+    // corner tracking between marker detections
+    cv::Mat prev_grayscale;
+    std::vector<aruco::Marker> prev_markers;
+    std::vector<cv::Point2f> prev_corners, flow_corners;
+    std::vector<unsigned char> flow_status;
+    std::vector<float> flow_error;
+    int frames_since_detect;
+    bool corners_from_flow;
+    // overlay stats. frame_ms is the last loop iteration after the read,
+    // lost_since is the capture time of the first frame without the
+    // marker, or -1 while tracking
+    double detect_ms, frame_ms, recovery_ms, lost_since;
     double freq, cur_fps;
     std::uint64_t last_time;
 
@@ -125,6 +186,7 @@ private slots:
     void toggleCalibrate();
     void cleanupCalib();
     void update_tracker_calibration();
+    void browse_board();
 };
 
 class TrackerDll : public Metadata
@@ -5,6 +5,7 @@
 #include <cmath>
 #include "api/camera-names.hpp"
 #include "compat/sleep.hpp"
+#include "compat/timer.hpp"
 
 typedef struct {
         int width;
@@ -75,6 +76,7 @@ void Tracker::load_settings(ht_config_t* config)
 Tracker::Tracker() :
     ht(nullptr),
     ypr {0,0,0, 0,0,0},
+    sample { 0, 0 },
     videoWidget(nullptr),
     layout(nullptr),
     should_stop(false)
@@ -116,6 +118,7 @@ void Tracker::run()
     {
         ht_result_t euler;
         euler.filled = false;
+        const double timestamp = Timer::monotonic_seconds();
         {
             QMutexLocker l(&camera_mtx);
 
@@ -131,33 +134,12 @@ void Tracker::run()
             ypr[Yaw] = euler.rotx;
             ypr[Pitch] = euler.roty;
             ypr[Roll] = euler.rotz;
+            sample.timestamp = timestamp;
+            sample.seq++;
+            notify_new_data();
         }
-        {
-            const cv::Mat frame_ = ht_get_bgr_frame(ht);
-            if (frame_.cols <= HT_MAX_VIDEO_WIDTH && frame_.rows <= HT_MAX_VIDEO_HEIGHT && frame_.channels() <= HT_MAX_VIDEO_CHANNELS)
-            {
-                QMutexLocker l(&frame_mtx);
-
-                const int cols = frame_.cols;
-                const int rows = frame_.rows;
-                const int pitch = cols * 3;
-                for (int y = 0; y < rows; y++)
-                {
-                    for (int x = 0; x < cols; x++)
-                    {
-                        unsigned char* dest = &frame.frame[y * pitch + 3 * x];
-                        const cv::Vec3b& elt = frame_.at<cv::Vec3b>(y, x);
-                        const cv::Scalar elt2 = static_cast<cv::Scalar>(elt);
-                        dest[0] = elt2.val[0];
-                        dest[1] = elt2.val[1];
-                        dest[2] = elt2.val[2];
-                    }
-                }
-                frame.channels = frame_.channels();
-                frame.width = frame_.cols;
-                frame.height = frame_.rows;
-            }
-        }
+        // the widget copies it only when it's about to paint
+        videoWidget->update_image(ht_get_bgr_frame(ht));
     }
     // give opencv time to exit camera threads, etc.
     portable::sleep(500);
@@ -165,22 +147,25 @@ void Tracker::run()
 
 void Tracker::data(double* data)
 {
-    {
-        QMutexLocker l(&frame_mtx);
+    QMutexLocker l(&ypr_mtx);
 
-        if (frame.width > 0)
-        {
-            videoWidget->update_image(frame.frame, frame.width, frame.height);
-            frame.width = 0;
-        }
-    }
+    for (int i = 0; i < 6; i++)
+        data[i] = ypr[i];
+}
 
-    {
-        QMutexLocker l(&ypr_mtx);
+bool Tracker::data_ex(double* data, sample_info& info)
+{
+    QMutexLocker l(&ypr_mtx);
 
-        for (int i = 0; i < 6; i++)
-            data[i] = ypr[i];
-    }
+    if (sample.seq == 0)
+        return false;
+
+    for (int i = 0; i < 6; i++)
+        data[i] = ypr[i];
+
+    info = sample;
+
+    return true;
 }
 
 TrackerControls::TrackerControls() : tracker(nullptr)
@@ -46,17 +46,20 @@ public:
     void run() override;
     void start_tracker(QFrame* frame) override;
     void data(double *data) override;
+    bool data_ex(double *data, sample_info& info) override;
+    bool is_event_driven() override { return true; }
     void load_settings(ht_config_t* config);
     headtracker_t* ht;
     QMutex camera_mtx;
 private:
     double ypr[6];
+    // ht_cycle grabs the frame itself, so this is the time it was entered
+    sample_info sample;
     settings s;
     ht_config_t conf;
     HTVideoWidget* videoWidget;
     QHBoxLayout* layout;
-    QMutex ypr_mtx, frame_mtx;
-    ht_video_t frame;
+    QMutex ypr_mtx;
     volatile bool should_stop;
 };
 
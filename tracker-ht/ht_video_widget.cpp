@@ -7,44 +7,32 @@
 
 #include "ht_video_widget.h"
 
-void HTVideoWidget::update_image(unsigned char *frame, int width_, int height_)
+void HTVideoWidget::update_image(const cv::Mat& frame)
 {
     QMutexLocker foo(&mtx);
-    if (!fresh)
+    if (!fresh && frame.type() == CV_8UC3)
     {
-        width = width_;
-        height = height_;
+        frame.copyTo(back);
         fresh = true;
-        memcpy(fb, frame, width_ * height_ * 3);
     }
 }
 
 void HTVideoWidget::update_and_repaint()
 {
-    QImage qframe;
     {
         QMutexLocker foo(&mtx);
-        if (width*height <= 0 || !fresh)
+        if (!fresh)
             return;
+        cv::swap(front, back);
         fresh = false;
-        qframe = QImage(width, height, QImage::Format_RGB888);
-        uchar* data = qframe.bits();
-        const int pitch = qframe.bytesPerLine();
-        for (int y = 0; y < height; y++)
-        {
-            const int part = y*width;
-            for (int x = 0; x < width; x++)
-            {
-                const int pos = 3 * (part + x);
-                const int x_ = x * 3;
-                data[x_ + 0] = fb[pos + 2];
-                data[x_ + 1] = fb[pos + 1];
-                data[x_ + 2] = fb[pos + 0];
-            }
-            data += pitch;
-        }
     }
-    qframe = qframe.scaled(size(), Qt::IgnoreAspectRatio, Qt::FastTransformation);
+
+    if (front.empty())
+        return;
+
+    const QImage qframe = QImage(front.data, front.cols, front.rows, int(front.step), QImage::Format_RGB888)
+                          .scaled(size(), Qt::IgnoreAspectRatio, Qt::FastTransformation)
+                          .rgbSwapped();
     {
         QMutexLocker foo(&mtx);
         texture = qframe;
@@ -6,6 +6,8 @@
  */
 #pragma once
 
+#include <opencv2/core.hpp>
+
 #include <QTimer>
 #include <QWidget>
 #include <QMutex>
@@ -17,11 +19,13 @@ class HTVideoWidget : public QWidget
 {
     Q_OBJECT
 public:
-    HTVideoWidget(QWidget *parent) : QWidget(parent), fb(), width(0), height(0), fresh(false) {
+    HTVideoWidget(QWidget *parent) : QWidget(parent), fresh(false) {
         connect(&timer, SIGNAL(timeout()), this, SLOT(update_and_repaint()));
         timer.start(60);
     }
-    void update_image(unsigned char* frame, int width, int height);
+    // from the tracker thread. BGR frame, copied only if the last one
+    // got painted already.
+    void update_image(const cv::Mat& frame);
 protected slots:
     void paintEvent( QPaintEvent* e ) {
         QMutexLocker foo(&mtx);
@@ -33,7 +37,8 @@ private:
     QMutex mtx;
     QImage texture;
     QTimer timer;
-    unsigned char fb[2048*2048*3];
-    int width,height;
+    // the tracker writes `back' while not fresh. the two only get
+    // swapped under the mutex, after which `front' is ours alone.
+    cv::Mat front, back;
     bool fresh;
 };
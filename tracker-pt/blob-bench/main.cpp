@@ -0,0 +1,321 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+// compares the run-length blob labeller against the floodFill-based
+// extraction it replaced, on synthetic frames with a few LEDs and noise.
+// also checks the fused grayscale+histogram kernel against opencv bit
+// for bit, and times it. then measures how close sub-pixel centroid
+// refinement gets to known blob centers, and what it costs per frame.
+
+#include "tracker-pt/blob-labeller.hpp"
+#include "tracker-pt/gray-hist.hpp"
+#include "tracker-pt/centroid-refine.hpp"
+#include "compat/timer.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct centroid
+{
+    double x, y;
+    int area;
+};
+
+static void make_frame(cv::Mat& gray, unsigned k)
+{
+    cv::RNG rng(k);
+
+    gray.create(480, 640, CV_8U);
+    rng.fill(gray, cv::RNG::UNIFORM, 0, 40);
+
+    // three LEDs moving around, and a larger reflection
+    for (int i = 0; i < 3; i++)
+    {
+        const double t = k * .05 + i * 2.1;
+        const cv::Point c(int(320 + 200 * std::cos(t)), int(240 + 150 * std::sin(t * 1.3)));
+        cv::circle(gray, c, 5 + i, cv::Scalar(255), -1);
+        cv::circle(gray, c, 7 + i, cv::Scalar(160), 2);
+    }
+    cv::ellipse(gray, cv::Point(100, 400), cv::Size(30, 8), 20, 0, 360, cv::Scalar(200), -1);
+}
+
+// the old PointExtractor path: threshold, copy, floodFill per seed, then moments over the rect
+static void extract_floodfill(const cv::Mat& gray, int thres, unsigned max_blobs,
+                              cv::Mat& bin, std::vector<centroid>& ret)
+{
+    ret.clear();
+    cv::threshold(gray, bin, thres, 255, cv::THRESH_BINARY);
+
+    unsigned idx = 0;
+    for (int y = 0; y < bin.rows; y++)
+    {
+        if (idx > max_blobs) break;
+
+        const unsigned char* ptr_bin = bin.ptr(y);
+        for (int x = 0; x < bin.cols; x++)
+        {
+            if (idx > max_blobs) break;
+            if (ptr_bin[x] != 255)
+                continue;
+            idx = unsigned(ret.size()) + 1;
+            cv::Rect rect;
+            cv::floodFill(bin, cv::Point(x, y), cv::Scalar(idx), &rect, cv::Scalar(0), cv::Scalar(0), 8);
+            double m00 = 0, m10 = 0, m01 = 0;
+            int cnt = 0;
+            for (int i = rect.y; i < rect.y + rect.height; i++)
+            {
+                unsigned char* ptr_blobs = bin.ptr(i);
+                const unsigned char* ptr_gray = gray.ptr(i);
+                for (int j = rect.x; j < rect.x + rect.width; j++)
+                {
+                    if (ptr_blobs[j] != idx) continue;
+                    ptr_blobs[j] = 0;
+                    const double val = ptr_gray[j];
+                    m00 += val;
+                    m01 += i * val;
+                    m10 += j * val;
+                    cnt++;
+                }
+            }
+            ret.push_back(centroid { m10 / m00, m01 / m00, cnt });
+        }
+    }
+}
+
+static void extract_labeller(blob_labeller& l, const cv::Mat& gray, int thres, unsigned max_blobs,
+                             std::vector<centroid>& ret)
+{
+    ret.clear();
+    (void) l.label(gray, thres, 0, INT_MAX, max_blobs);
+    for (const blob_labeller::component& c : l.components())
+        ret.push_back(centroid { c.m10 / c.m00, c.m01 / c.m00, c.area });
+}
+
+// returns the number of mismatching pixels and histogram bins
+static unsigned check_gray_hist(unsigned frames, double& opencv_us, double& fused_us)
+{
+    cv::RNG rng(1);
+    cv::Mat bgr(480, 640, CV_8UC3), gray_cv, gray(480, 640, CV_8U), hist_cv;
+    unsigned hist[256];
+    unsigned bad = 0;
+
+    // odd widths exercise the scalar tail after the vector loop
+    for (int w : { 640, 333, 17, 1 })
+    {
+        rng.fill(bgr, cv::RNG::UNIFORM, 0, 256);
+        const cv::Rect roi(0, 0, w, 480);
+        cv::Mat gray_roi = gray(roi);
+
+        cv::cvtColor(bgr(roi), gray_cv, cv::COLOR_RGB2GRAY);
+        cv::calcHist(std::vector<cv::Mat> { gray_cv }, std::vector<int> { 0 }, cv::Mat(), hist_cv,
+                     std::vector<int> { 256 }, std::vector<float> { 0, 256 }, false);
+        gray_hist(bgr(roi), gray_roi, hist);
+
+        bad += unsigned(cv::countNonZero(gray_cv != gray_roi));
+        for (int i = 0; i < 256; i++)
+            if (unsigned(hist_cv.at<float>(i)) != hist[i])
+                bad++;
+    }
+
+    // grayscale input, as from native capture, only wants the histogram
+    gray_hist(gray, gray, hist);
+    cv::calcHist(std::vector<cv::Mat> { gray }, std::vector<int> { 0 }, cv::Mat(), hist_cv,
+                 std::vector<int> { 256 }, std::vector<float> { 0, 256 }, false);
+    for (int i = 0; i < 256; i++)
+        if (unsigned(hist_cv.at<float>(i)) != hist[i])
+            bad++;
+
+    Timer t;
+    for (unsigned k = 0; k < frames; k++)
+    {
+        cv::cvtColor(bgr, gray_cv, cv::COLOR_RGB2GRAY);
+        cv::calcHist(std::vector<cv::Mat> { gray_cv }, std::vector<int> { 0 }, cv::Mat(), hist_cv,
+                     std::vector<int> { 256 }, std::vector<float> { 0, 256 }, false);
+    }
+    opencv_us = t.elapsed_nsecs() * 1e-3 / std::max(1u, frames);
+
+    t.start();
+    for (unsigned k = 0; k < frames; k++)
+        gray_hist(bgr, gray, hist);
+    fused_us = t.elapsed_nsecs() * 1e-3 / std::max(1u, frames);
+
+    return bad;
+}
+
+// gaussian spots at known sub-pixel centers on a noisy background,
+// clipped at 255 like an overexposed LED
+static void make_spots(cv::Mat& gray, cv::RNG& rng, std::vector<cv::Point2d>& centers)
+{
+    gray.create(480, 640, CV_8U);
+    centers.clear();
+
+    cv::Mat noise(gray.size(), CV_32F);
+    rng.fill(noise, cv::RNG::NORMAL, 20, 4);
+
+    for (int i = 0; i < 3; i++)
+    {
+        const cv::Point2d c(rng.uniform(100., 540.), 120 + i * 120 + rng.uniform(-20., 20.));
+        const double s = rng.uniform(1.5, 3.5), peak = rng.uniform(150., 400.);
+        centers.push_back(c);
+
+        for (int y = int(c.y) - 15; y <= int(c.y) + 15; y++)
+        {
+            float* row = noise.ptr<float>(y);
+            for (int x = int(c.x) - 15; x <= int(c.x) + 15; x++)
+            {
+                const double dx = x - c.x, dy = y - c.y;
+                row[x] += float(peak * std::exp(-(dx*dx + dy*dy) / (2*s*s)));
+            }
+        }
+    }
+
+    noise.convertTo(gray, CV_8U);
+}
+
+struct refine_stats
+{
+    double rms[3]; // per centroid_weighting
+    double mean_sigma[3];
+    double us[3];
+    unsigned n;
+};
+
+static refine_stats check_refine(unsigned frames, int thres)
+{
+    static constexpr unsigned trials = 200;
+
+    cv::RNG rng(2);
+    blob_labeller l;
+    std::vector<cv::Mat> grays(trials);
+    std::vector<std::vector<cv::Point2d>> all_centers(trials);
+
+    refine_stats ret {};
+
+    for (unsigned k = 0; k < trials; k++)
+        make_spots(grays[k], rng, all_centers[k]);
+
+    for (int w = centroid_mask; w <= centroid_squared; w++)
+    {
+        double sq = 0, sig = 0;
+        unsigned n = 0;
+
+        for (unsigned k = 0; k < trials; k++)
+        {
+            (void) l.label(grays[k], thres, 0, INT_MAX, 16);
+            for (const blob_labeller::component& c : l.components())
+            {
+                double x = c.m10 / c.m00, y = c.m01 / c.m00, sigma = 0;
+                const double radius = std::sqrt(c.area / 3.14159265358979323846);
+                (void) refine_centroid(grays[k], radius, centroid_weighting(w), x, y, sigma);
+
+                double best = 1e9;
+                for (const cv::Point2d& p : all_centers[k])
+                    best = std::min(best, (p.x - x) * (p.x - x) + (p.y - y) * (p.y - y));
+                sq += best;
+                sig += sigma * sigma;
+                n++;
+            }
+        }
+
+        ret.rms[w] = std::sqrt(sq / (2 * std::max(1u, n))); // per axis, like sigma
+        ret.mean_sigma[w] = std::sqrt(sig / std::max(1u, n));
+        ret.n = n;
+
+        Timer t;
+        for (unsigned k = 0; k < frames; k++)
+        {
+            const cv::Mat& gray = grays[k % trials];
+            (void) l.label(gray, thres, 0, INT_MAX, 16);
+            for (const blob_labeller::component& c : l.components())
+            {
+                double x = c.m10 / c.m00, y = c.m01 / c.m00, sigma;
+                (void) refine_centroid(gray, std::sqrt(c.area / 3.14159265358979323846), centroid_weighting(w), x, y, sigma);
+            }
+        }
+        ret.us[w] = t.elapsed_nsecs() * 1e-3 / std::max(1u, frames);
+    }
+
+    return ret;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned frames = argc > 1 ? unsigned(std::atoi(argv[1])) : 1000u;
+    static constexpr int thres = 128;
+    static constexpr unsigned max_blobs = 16;
+
+    std::vector<cv::Mat> grays(16);
+    for (unsigned k = 0; k < grays.size(); k++)
+        make_frame(grays[k], k);
+
+    cv::Mat bin;
+    blob_labeller labeller;
+    std::vector<centroid> a, b;
+
+    double max_err = 0;
+    unsigned mismatches = 0;
+
+    for (const cv::Mat& gray : grays)
+    {
+        extract_floodfill(gray, thres, max_blobs, bin, a);
+        extract_labeller(labeller, gray, thres, max_blobs, b);
+
+        if (a.size() != b.size())
+        {
+            mismatches++;
+            continue;
+        }
+
+        for (unsigned i = 0; i < a.size(); i++)
+        {
+            if (a[i].area != b[i].area)
+                mismatches++;
+            max_err = std::max(max_err, std::max(std::fabs(a[i].x - b[i].x), std::fabs(a[i].y - b[i].y)));
+        }
+    }
+
+    Timer t;
+    for (unsigned k = 0; k < frames; k++)
+        extract_floodfill(grays[k % grays.size()], thres, max_blobs, bin, a);
+    const double floodfill_us = t.elapsed_nsecs() * 1e-3 / std::max(1u, frames);
+
+    t.start();
+    for (unsigned k = 0; k < frames; k++)
+        extract_labeller(labeller, grays[k % grays.size()], thres, max_blobs, b);
+    const double labeller_us = t.elapsed_nsecs() * 1e-3 / std::max(1u, frames);
+
+    std::printf("640x480, %u frames\n", frames);
+    std::printf("floodfill   %8.1f us/frame\n", floodfill_us);
+    std::printf("labeller    %8.1f us/frame\n", labeller_us);
+    std::printf("mismatches  %u, max centroid difference %g px\n", mismatches, max_err);
+
+    double opencv_us, fused_us;
+    const unsigned gray_bad = check_gray_hist(frames, opencv_us, fused_us);
+
+    std::printf("\ncvtColor+calcHist  %8.1f us/frame\n", opencv_us);
+    std::printf("gray_hist (%s) %8.1f us/frame\n", gray_hist_kernel_name(), fused_us);
+    std::printf("gray/hist mismatches %u\n", gray_bad);
+
+    // a threshold near the spots' flanks, as the thresholded centroid gets
+    // worse the more of each spot it cuts off
+    const refine_stats r = check_refine(frames, 100);
+    static const char* const names[] = { "mask", "linear", "squared" };
+
+    std::printf("\ncentroids of %u gaussian spots, label+refine per frame\n", r.n);
+    for (int w = centroid_mask; w <= centroid_squared; w++)
+        std::printf("%-8s rms error per axis %6.3f px, predicted %6.3f px, %8.1f us/frame\n",
+                    names[w], r.rms[w], r.mean_sigma[w], r.us[w]);
+
+    return mismatches != 0 || gray_bad != 0;
+}
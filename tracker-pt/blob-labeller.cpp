@@ -0,0 +1,146 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "blob-labeller.hpp"
+
+#include <utility>
+
+unsigned blob_labeller::find(unsigned x)
+{
+    while (parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+void blob_labeller::unite(unsigned a, unsigned b)
+{
+    a = find(a);
+    b = find(b);
+
+    if (a == b)
+        return;
+
+    // keep the older label as root, so components stay in raster order
+    if (b < a)
+        std::swap(a, b);
+
+    parent[b] = a;
+
+    component& dst = stats[a];
+    const component& src = stats[b];
+    dst.m00 += src.m00;
+    dst.m10 += src.m10;
+    dst.m01 += src.m01;
+    dst.area += src.area;
+}
+
+unsigned blob_labeller::new_label()
+{
+    const unsigned ret = unsigned(parent.size());
+    parent.push_back(ret);
+    stats.push_back(component { 0, 0, 0, 0 });
+    live.push_back(0);
+    return ret;
+}
+
+bool blob_labeller::label(const cv::Mat& gray, int threshold, int min_area, int max_area, unsigned max_components)
+{
+    prev.clear();
+    cur.clear();
+    parent.clear();
+    stats.clear();
+    live.clear();
+    result.clear();
+
+    const int W = gray.cols, H = gray.rows;
+    unsigned complete = 0;
+    int y = 0;
+
+    for (; y < H; y++)
+    {
+        const unsigned char* ptr = gray.ptr(y);
+        unsigned j = 0;
+
+        for (int x = 0; x < W; x++)
+        {
+            if (ptr[x] <= threshold)
+                continue;
+
+            run r;
+            r.x0 = x;
+
+            double m00 = 0, m10 = 0;
+            int area = 0;
+
+            for (; x < W && ptr[x] > threshold; x++)
+            {
+                const double val = ptr[x];
+                m00 += val;
+                m10 += x * val;
+                area++;
+            }
+
+            r.x1 = x - 1;
+
+            // runs in the previous row touching this one, diagonals included
+            while (j < prev.size() && prev[j].x1 < r.x0 - 1)
+                j++;
+
+            unsigned k = j;
+
+            if (k < prev.size() && prev[k].x0 <= r.x1 + 1)
+            {
+                r.label = prev[k++].label;
+                for (; k < prev.size() && prev[k].x0 <= r.x1 + 1; k++)
+                    unite(r.label, prev[k].label);
+            }
+            else
+                r.label = new_label();
+
+            component& c = stats[find(r.label)];
+            c.m00 += m00;
+            c.m10 += m10;
+            c.m01 += y * m00;
+            c.area += area;
+
+            cur.push_back(r);
+        }
+
+        for (const run& r : cur)
+            live[find(r.label)] = y;
+
+        // whatever didn't continue into this row is complete
+        for (const run& r : prev)
+        {
+            const unsigned root = find(r.label);
+            if (live[root] != y && live[root] >= 0)
+            {
+                live[root] = -1;
+                const int area = stats[root].area;
+                if (area >= min_area && area <= max_area)
+                    complete++;
+            }
+        }
+
+        std::swap(prev, cur);
+        cur.clear();
+
+        if (complete > max_components)
+            break;
+    }
+
+    const bool ret = y >= H;
+
+    for (unsigned i = 0; i < parent.size(); i++)
+        if (parent[i] == i && (ret || live[i] != y))
+            result.push_back(stats[i]);
+
+    return ret;
+}
@@ -0,0 +1,55 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// 8-connected components of the pixels brighter than a threshold, found
+// in a single pass over the rows. runs of bright pixels get joined with
+// the runs touching them in the previous row using union-find, moments
+// are summed up into each component's root as the row is scanned.
+class blob_labeller final
+{
+public:
+    struct component
+    {
+        // intensity-weighted moments, x and y in pixels
+        double m00, m10, m01;
+        int area;
+    };
+
+    // gray must be CV_8U. stops early and returns false once more than
+    // max_components components with min_area <= area <= max_area are
+    // complete. components still crossing the last row scanned are
+    // dropped then, they'd be cut short. the rest are kept, whatever
+    // their area.
+    bool label(const cv::Mat& gray, int threshold, int min_area, int max_area, unsigned max_components);
+
+    // in order of each component's first pixel
+    const std::vector<component>& components() const { return result; }
+
+private:
+    struct run
+    {
+        int x0, x1; // inclusive
+        unsigned label;
+    };
+
+    std::vector<run> prev, cur;
+    std::vector<unsigned> parent;
+    // valid for roots only
+    std::vector<component> stats;
+    // per root, the last row it had a run in, or -1 once it's complete
+    std::vector<int> live;
+    std::vector<component> result;
+
+    unsigned find(unsigned x);
+    void unite(unsigned a, unsigned b);
+    unsigned new_label();
+};
@@ -8,6 +8,7 @@
 #include "camera.h"
 #include "compat/sleep.hpp"
 #include "compat/camera-names.hpp"
+#include "compat/timer.hpp"
 #include <string>
 #include <QDebug>
 
@@ -23,7 +24,7 @@ void Camera::set_device(const QString& name)
         _set_device_index();
 
         // reset fps
-        dt_valid = 0;
+        last_timestamp = -1;
         dt_mean = 0;
         active_index = index;
     }
@@ -63,17 +64,21 @@ bool Camera::get_info(CamInfo& ret)
     return true;
 }
 
-bool Camera::get_frame(double dt, cv::Mat* frame)
+bool Camera::get_frame(cv::Mat* frame, double& timestamp)
 {
-    bool new_frame = _get_frame(frame);
-    // measure fps of valid frames
+    timestamp = -1;
+    bool new_frame = _get_frame(frame, timestamp);
+    if (!(timestamp >= 0))
+        timestamp = Timer::monotonic_seconds();
+    // measure fps of valid frames, by when they were captured
     static constexpr double dt_smoothing_const = 0.95;
-    dt_valid += dt;
     if (new_frame)
     {
-        dt_mean = dt_smoothing_const * dt_mean + (1 - dt_smoothing_const) * dt_valid;
+        const double dt = last_timestamp < 0 ? 0 : timestamp - last_timestamp;
+        last_timestamp = timestamp;
+        if (dt > 0)
+            dt_mean = dt_smoothing_const * dt_mean + (1 - dt_smoothing_const) * dt;
         cam_info.fps = int(std::round(dt_mean > 1e-3 ? 1 / dt_mean : 0));
-        dt_valid = 0;
     }
     else
         qDebug() << "pt camera: can't get frame";
@@ -116,7 +121,7 @@ void CVCamera::stop()
     }
 }
 
-bool CVCamera::_get_frame(cv::Mat* frame)
+bool CVCamera::_get_frame(cv::Mat* frame, double&)
 {
     if (cap && cap->isOpened())
     {
@@ -151,3 +156,54 @@ void CVCamera::_set_device_index()
     if (desired_index != active_index)
         stop();
 }
+
+#ifdef __linux
+void V4L2Camera::start()
+{
+    stop();
+    if (cap.open(desired_index, cam_desired.res_x, cam_desired.res_y, cam_desired.fps))
+    {
+        active_index = desired_index;
+        cam_info.res_x = 0;
+        cam_info.res_y = 0;
+    }
+}
+
+void V4L2Camera::stop()
+{
+    if (cap.is_open())
+    {
+        cap.close();
+        qDebug() << "pt camera: stopped";
+    }
+}
+
+bool V4L2Camera::_get_frame(cv::Mat* frame, double& timestamp)
+{
+    if (!cap.read(*frame, timestamp, 500))
+        return false;
+
+    cam_info.res_x = frame->cols;
+    cam_info.res_y = frame->rows;
+    return true;
+}
+
+// the format can't change while streaming, open again with the new one
+void V4L2Camera::_set_fps()
+{
+    if (cap.is_open())
+        start();
+}
+
+void V4L2Camera::_set_res()
+{
+    if (cap.is_open())
+        start();
+}
+
+void V4L2Camera::_set_device_index()
+{
+    if (desired_index != active_index)
+        stop();
+}
+#endif
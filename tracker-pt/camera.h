@@ -13,13 +13,19 @@
 #include <string>
 #include <QString>
 
+#include "cv/v4l2-capture.hpp"
+
 struct CamInfo
 {
-    CamInfo() : res_x(0), res_y(0), fps(0) {}
+    CamInfo() : res_x(0), res_y(0), fps(0), process_fps(0), dropped(0) {}
 
     int res_x;
     int res_y;
+    // capture rate
     int fps;
+    // for trackers processing frames on a separate thread
+    int process_fps;
+    unsigned dropped;
 };
 
 // ----------------------------------------------------------------------------
@@ -27,7 +33,7 @@ struct CamInfo
 class Camera
 {
 public:
-        Camera() : dt_valid(0), dt_mean(0), desired_index(0), active_index(-1) {}
+        Camera() : last_timestamp(-1), dt_mean(0), desired_index(0), active_index(-1) {}
         virtual ~Camera() = 0;
 
         // start/stop capturing
@@ -40,8 +46,10 @@ public:
         void set_fps(int fps);
         void set_res(int x_res, int y_res);
 
-        // gets a frame from the camera, dt: time since last call in seconds
-        bool get_frame(double dt, cv::Mat* frame);
+        // gets a frame from the camera. timestamp: when it was captured, in
+        // seconds on the Timer::monotonic_seconds() clock. from the driver if
+        // the backend knows, otherwise when the frame got dequeued.
+        bool get_frame(cv::Mat* frame, double& timestamp);
 
         // WARNING: returned references are valid as long as object
         bool get_info(CamInfo &ret);
@@ -49,15 +57,15 @@ public:
 
         QString get_desired_name() const;
 protected:
-        // get a frame from the camera
-        virtual bool _get_frame(cv::Mat* frame) = 0;
+        // get a frame from the camera, leave timestamp alone unless the driver has one
+        virtual bool _get_frame(cv::Mat* frame, double& timestamp) = 0;
 
         // update the camera using cam_desired, write res and f to cam_info if successful
         virtual void _set_device_index() = 0;
         virtual void _set_fps() = 0;
         virtual void _set_res() = 0;
 private:
-        double dt_valid;
+        double last_timestamp;
         double dt_mean;
 protected:
         CamInfo cam_info;
@@ -82,7 +90,7 @@ public:
     operator cv::VideoCapture*() { return cap; }
 
 protected:
-    bool _get_frame(cv::Mat* frame) override;
+    bool _get_frame(cv::Mat* frame, double& timestamp) override;
     void _set_fps() override;
     void _set_res() override;
     void _set_device_index() override;
@@ -90,6 +98,29 @@ private:
     cv::VideoCapture* cap;
 };
 
+#ifdef __linux
+// ----------------------------------------------------------------------------
+// camera using video4linux directly, gives grayscale CV_8UC1 frames
+class V4L2Camera : public Camera
+{
+public:
+    ~V4L2Camera() { stop(); }
+
+    void start() override;
+    void stop() override;
+
+    bool is_open() const { return cap.is_open(); }
+
+protected:
+    bool _get_frame(cv::Mat* frame, double& timestamp) override;
+    void _set_fps() override;
+    void _set_res() override;
+    void _set_device_index() override;
+private:
+    v4l2_capture cap;
+};
+#endif
+
 enum RotationType
 {
     CLOCKWISE = 0,
@@ -0,0 +1,108 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "centroid-refine.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool refine_centroid(const cv::Mat& gray, double radius, centroid_weighting weighting,
+                     double& x_, double& y_, double& sigma_)
+{
+    using std::max;
+    using std::min;
+    using std::sqrt;
+
+    if (weighting == centroid_mask)
+        return false;
+
+    const int half = int(std::ceil(radius * 2)) + 1;
+
+    double x = x_, y = y_, sigma = 0;
+
+    // the thresholded centroid can be off by a good fraction of a pixel,
+    // recenter the window once if it moved to another one
+    for (int iter = 0; iter < 2; iter++)
+    {
+        const int cx = int(std::lround(x)), cy = int(std::lround(y));
+        const int x0 = cx - half, x1 = cx + half;
+        const int y0 = cy - half, y1 = cy + half;
+
+        if (x0 < 0 || y0 < 0 || x1 >= gray.cols || y1 >= gray.rows)
+            return false;
+
+        // background from the window's border
+        double bsum = 0, bsq = 0;
+        int bn = 0;
+        for (int j = y0; j <= y1; j++)
+        {
+            const unsigned char* row = gray.ptr(j);
+            if (j == y0 || j == y1)
+            {
+                for (int i = x0; i <= x1; i++)
+                {
+                    const double v = row[i];
+                    bsum += v; bsq += v * v; bn++;
+                }
+            }
+            else
+            {
+                const double v0 = row[x0], v1 = row[x1];
+                bsum += v0 + v1; bsq += v0 * v0 + v1 * v1; bn += 2;
+            }
+        }
+
+        const double bg = bsum / bn;
+        // at least the quantization noise
+        const double noise = max(.5, sqrt(max(0., bsq / bn - bg * bg)));
+
+        // moments relative to the window center. s* are sums of the
+        // squared derivative of each weight wrt. its pixel, for the error.
+        double m00 = 0, m10 = 0, m01 = 0;
+        double s0 = 0, sx = 0, sy = 0, sxx = 0, syy = 0;
+
+        for (int j = y0; j <= y1; j++)
+        {
+            const unsigned char* row = gray.ptr(j);
+            const double dy = j - cy;
+            for (int i = x0; i <= x1; i++)
+            {
+                const double v = row[i] - bg;
+                if (v <= 0)
+                    continue;
+                const double dx = i - cx;
+                double w, d2;
+                if (weighting == centroid_linear)
+                    w = v, d2 = 1;
+                else
+                    w = v * v, d2 = 4 * v * v;
+                m00 += w; m10 += w * dx; m01 += w * dy;
+                s0 += d2; sx += d2 * dx; sy += d2 * dy;
+                sxx += d2 * dx * dx; syy += d2 * dy * dy;
+            }
+        }
+
+        if (!(m00 > 0))
+            return false;
+
+        const double mx = m10 / m00, my = m01 / m00;
+
+        // var(mx) = noise^2 * sum(d_i^2 * (x_i - mx)^2) / m00^2
+        const double var_x = max(0., sxx - 2 * mx * sx + mx * mx * s0);
+        const double var_y = max(0., syy - 2 * my * sy + my * my * s0);
+        sigma = noise * sqrt((var_x + var_y) * .5) / m00;
+
+        const double x_new = cx + mx, y_new = cy + my;
+        x = x_new; y = y_new;
+
+        if (std::lround(x) == cx && std::lround(y) == cy)
+            break;
+    }
+
+    x_ = x; y_ = y; sigma_ = sigma;
+    return true;
+}
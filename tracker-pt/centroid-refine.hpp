@@ -0,0 +1,28 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+// how pixels around a blob count toward its refined centroid,
+// after subtracting the background level
+enum centroid_weighting
+{
+    centroid_mask,      // no refinement, moments over the thresholded pixels only
+    centroid_linear,    // w = v - bg
+    centroid_squared,   // w = (v - bg)^2, favors the core over the blob's flanks
+};
+
+// refines a blob's thresholded centroid (x, y) using the un-thresholded
+// pixels in a window of twice the blob's radius around it. background
+// level and noise come from the window's border. sigma receives the
+// standard error of the centroid in pixels, propagated from that noise.
+// gray must be CV_8U. returns false and leaves x, y, sigma alone if the
+// window runs off the image or has nothing above the background.
+bool refine_centroid(const cv::Mat& gray, double radius, centroid_weighting weighting,
+                     double& x, double& y, double& sigma);
@@ -0,0 +1,89 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "frame-ring.hpp"
+#include <QMutexLocker>
+#include <algorithm>
+
+constexpr unsigned frame_ring::size;
+
+frame_ring::frame_ring() : nfree(size), nready(0), ndropped(0)
+{
+    for (unsigned i = 0; i < size; i++)
+    {
+        frames[i].timestamp = 0;
+        free_idx[i] = i;
+    }
+}
+
+frame_ring::frame* frame_ring::get_free()
+{
+    QMutexLocker l(&mtx);
+
+    if (nfree > 0)
+        return &frames[free_idx[--nfree]];
+
+    // at most one buffer each is held by capture and processing,
+    // so there's always a ready one to take back.
+    const unsigned idx = ready_idx[0];
+    std::copy(ready_idx + 1, ready_idx + nready, ready_idx);
+    nready--;
+    ndropped++;
+
+    return &frames[idx];
+}
+
+void frame_ring::put_ready(frame* f)
+{
+    {
+        QMutexLocker l(&mtx);
+        ready_idx[nready++] = index_of(f);
+    }
+
+    ready_event.notify();
+}
+
+frame_ring::frame* frame_ring::get_ready()
+{
+    QMutexLocker l(&mtx);
+
+    if (nready == 0)
+        return nullptr;
+
+    for (unsigned i = 0; i + 1 < nready; i++)
+        free_idx[nfree++] = ready_idx[i];
+    ndropped += nready - 1;
+
+    const unsigned idx = ready_idx[nready - 1];
+    nready = 0;
+
+    return &frames[idx];
+}
+
+frame_ring::frame* frame_ring::wait_ready(unsigned msecs)
+{
+    frame* f = get_ready();
+
+    if (!f && ready_event.wait(msecs))
+        f = get_ready();
+
+    return f;
+}
+
+void frame_ring::put_free(frame* f)
+{
+    QMutexLocker l(&mtx);
+
+    free_idx[nfree++] = index_of(f);
+}
+
+unsigned frame_ring::dropped() const
+{
+    QMutexLocker l(&mtx);
+
+    return ndropped;
+}
@@ -0,0 +1,63 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "compat/sample-event.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <QMutex>
+
+// a fixed set of frame buffers passed between capture and processing.
+// only indices change hands, pixels are never copied. the buffers keep
+// their allocation, so after the first few frames nothing gets allocated.
+class frame_ring final
+{
+public:
+    struct frame
+    {
+        cv::Mat mat;
+        double timestamp;
+    };
+
+    static constexpr unsigned size = 4;
+
+    frame_ring();
+
+    // capture side. when processing falls behind, the oldest ready frame
+    // gets recycled, so this never fails.
+    frame* get_free();
+    void put_ready(frame* f);
+
+    // processing side. returns the newest ready frame or nullptr,
+    // any older ones are dropped.
+    frame* get_ready();
+    // same, but waits for a frame up to the timeout
+    frame* wait_ready(unsigned msecs);
+    void put_free(frame* f);
+
+    unsigned dropped() const;
+
+private:
+    frame frames[size];
+
+    mutable QMutex mtx;
+
+    // stack of free buffers
+    unsigned free_idx[size];
+    unsigned nfree;
+
+    // ready buffers, oldest first
+    unsigned ready_idx[size];
+    unsigned nready;
+
+    unsigned ndropped;
+
+    sample_event ready_event;
+
+    unsigned index_of(const frame* f) const { return unsigned(f - frames); }
+};
@@ -15,13 +15,19 @@
 #include "compat/camera-names.hpp"
 #include "compat/sleep.hpp"
 #include <functional>
+#include <algorithm>
 
 //#define PT_PERF_LOG	//log performance
 
 //-----------------------------------------------------------------------------
 Tracker_PT::Tracker_PT() :
+      published_sample { 0, 0 },
+      camera_native(false),
       video_widget(nullptr),
       video_frame(nullptr),
+      capture_thread(*this),
+      process_dt_mean(0),
+      process_fps(0),
       point_count(0),
       commands(0),
       ever_success(false)
@@ -42,7 +48,8 @@ Tracker_PT::~Tracker_PT()
     }
     // fast start/stop causes breakage
     portable::sleep(1000);
-    camera.stop();
+    if (camera)
+        camera->stop();
 }
 
 void Tracker_PT::set_command(Command command)
@@ -57,14 +64,10 @@ void Tracker_PT::reset_command(Command command)
     commands &= ~command;
 }
 
-bool Tracker_PT::get_focal_length(f& ret)
+bool Tracker_PT::get_focal_length(f& ret, int w, int h)
 {
-    QMutexLocker l(&camera_mtx);
-    CamInfo info;
-    const bool res = camera.get_info(info);
-    if (res)
+    if (w > 0 && h > 0)
     {
-        const int w = info.res_x, h = info.res_y;
         const double diag = sqrt(1. + h/(double)w * h/(double)w);
         const double diag_fov = static_cast<int>(s.fov) * pi / 180.;
         const double fov = 2.*atan(tan(diag_fov/2.0)/diag);
@@ -74,6 +77,110 @@ bool Tracker_PT::get_focal_length(f& ret)
     return false;
 }
 
+void Tracker_PT::set_roi(f fx, int w, int h)
+{
+    const PointModel model(s);
+
+    // the projected points need some room to move until the next frame
+    const int margin = int(std::sqrt(w*w + h*h) / 16);
+
+    int x0 = w, y0 = h, x1 = 0, y1 = 0;
+
+    for (unsigned i = 0; i < model.n_points; i++)
+    {
+        const vec2 p = point_tracker.project(model.points[i], fx);
+        const int x = int(p[0] * w + w/2), y = int(-p[1] * w + h/2);
+        x0 = std::min(x0, x); y0 = std::min(y0, y);
+        x1 = std::max(x1, x); y1 = std::max(y1, y);
+    }
+
+    roi = cv::Rect(x0 - margin, y0 - margin, x1 - x0 + 2 * margin, y1 - y0 + 2 * margin) & cv::Rect(0, 0, w, h);
+}
+
+void Tracker_PT::process_frame(cv::Mat& frame, double timestamp)
+{
+    point_extractor.extract_points(frame, points, point_sigma, roi);
+
+    // lost the points near where they were, look everywhere
+    if (points.size() < PointModel::N_POINTS && roi.area() > 0)
+    {
+        roi = cv::Rect();
+        point_extractor.extract_points(frame, points, point_sigma, roi);
+    }
+
+    point_count = points.size();
+
+    f fx;
+
+    if (!get_focal_length(fx, frame.cols, frame.rows))
+        return;
+
+    const bool success = points.size() >= PointModel::N_POINTS &&
+                         point_tracker.track(points,
+                                             point_sigma,
+                                             PointModel(s),
+                                             fx,
+                                             s.dynamic_pose,
+                                             s.init_phase_timeout,
+                                             frame.cols,
+                                             frame.rows);
+
+    if (success)
+    {
+        {
+            QMutexLocker l(&data_mtx);
+            published_X_CM = point_tracker.pose();
+            published_sample.timestamp = timestamp;
+            published_sample.seq++;
+        }
+
+        ever_success = true;
+        notify_new_data();
+
+        set_roi(fx, frame.cols, frame.rows);
+    }
+    else
+    {
+        // too few points, or they don't fit the model. the pose is stale,
+        // don't publish it and look everywhere next frame.
+        roi = cv::Rect();
+    }
+
+    std::function<void(const vec2&, const cv::Scalar)> fun = [&](const vec2& p, const cv::Scalar color)
+    {
+        using std::round;
+        cv::Point p2(round(p[0] * frame.cols + frame.cols/2),
+                     round(-p[1] * frame.cols + frame.rows/2));
+        cv::line(frame,
+                 cv::Point(p2.x - 20, p2.y),
+                 cv::Point(p2.x + 20, p2.y),
+                 color,
+                 2);
+        cv::line(frame,
+                 cv::Point(p2.x, p2.y - 20),
+                 cv::Point(p2.x, p2.y + 20),
+                 color,
+                 2);
+    };
+
+    for (unsigned i = 0; i < points.size(); i++)
+    {
+        fun(points[i], cv::Scalar(0, 255, 0));
+    }
+
+    {
+        const Affine X_CM = point_tracker.pose();
+
+        Affine X_MH(mat33::eye(), vec3(s.t_MH_x, s.t_MH_y, s.t_MH_z)); // just copy pasted these lines from below
+        Affine X_GH = X_CM * X_MH;
+        vec3 p = X_GH.t; // head (center?) position in global space
+        vec2 p_(p[0] / p[2] * fx, p[1] / p[2] * fx);  // projected to screen
+        fun(p_, cv::Scalar(0, 0, 255));
+    }
+
+    video_widget->update_image(frame);
+}
+
 void Tracker_PT::run()
 {
     cv::setNumThreads(0);
@@ -85,91 +192,90 @@ void Tracker_PT::run()
 #endif
 
     apply_settings();
-    cv::Mat frame_;
+    capture_thread.start();
 
     while((commands & ABORT) == 0)
     {
-        const double dt = time.elapsed_seconds();
-        time.start();
+        // time out now and then to notice ABORT
+        frame_ring::frame* cur = frames.wait_ready(100);
+
+        if (!cur)
+            continue;
+
+        process_frame(cur->mat, cur->timestamp);
+        frames.put_free(cur);
+
+        static constexpr double dt_smoothing_const = 0.95;
+        const double dt = process_time.elapsed_seconds();
+        process_time.start();
+        process_dt_mean = dt_smoothing_const * process_dt_mean + (1 - dt_smoothing_const) * dt;
+        process_fps = int(std::round(process_dt_mean > 1e-3 ? 1 / process_dt_mean : 0));
+    }
+
+    capture_thread.wait();
+
+    qDebug()<<"Tracker:: Thread stopping";
+}
+
+void Tracker_PT::capture_frames()
+{
+    while((commands & ABORT) == 0)
+    {
+        frame_ring::frame* buf = frames.get_free();
         bool new_frame;
 
         {
             QMutexLocker l(&camera_mtx);
-            new_frame = camera.get_frame(dt, &frame);
-            if (frame.rows != frame_.rows || frame.cols != frame_.cols)
-                frame_ = cv::Mat(frame.rows, frame.cols, CV_8UC3);
-            frame.copyTo(frame_);
+            new_frame = camera && camera->get_frame(&buf->mat, buf->timestamp);
         }
 
-        if (new_frame && !frame_.empty())
+        if (!new_frame || buf->mat.empty())
         {
-            CamInfo cam_info;
-
-            if (!camera.get_info(cam_info))
-                continue;
-
-            point_extractor.extract_points(frame_, points);
-            point_count = points.size();
-
-            f fx;
-
-            if (!get_focal_length(fx))
-                continue;
-
-            const bool success = points.size() >= PointModel::N_POINTS;
-
-            if (success)
-            {
-                point_tracker.track(points,
-                                    PointModel(s),
-                                    fx,
-                                    s.dynamic_pose,
-                                    s.init_phase_timeout,
-                                    cam_info.res_x,
-                                    cam_info.res_y);
-                ever_success = true;
-            }
-
-            std::function<void(const vec2&, const cv::Scalar)> fun = [&](const vec2& p, const cv::Scalar color)
-            {
-                using std::round;
-                cv::Point p2(round(p[0] * frame_.cols + frame_.cols/2),
-                             round(-p[1] * frame_.cols + frame_.rows/2));
-                cv::line(frame_,
-                         cv::Point(p2.x - 20, p2.y),
-                         cv::Point(p2.x + 20, p2.y),
-                         color,
-                         2);
-                cv::line(frame_,
-                         cv::Point(p2.x, p2.y - 20),
-                         cv::Point(p2.x, p2.y + 20),
-                         color,
-                         2);
-            };
-
-            for (unsigned i = 0; i < points.size(); i++)
-            {
-                fun(points[i], cv::Scalar(0, 255, 0));
-            }
-
-            {
-                Affine X_CM;
-                {
-                    QMutexLocker l(&data_mtx);
-                    X_CM = point_tracker.pose();
-                }
-
-                Affine X_MH(mat33::eye(), vec3(s.t_MH_x, s.t_MH_y, s.t_MH_z)); // just copy pasted these lines from below
-                Affine X_GH = X_CM * X_MH;
-                vec3 p = X_GH.t; // head (center?) position in global space
-                vec2 p_(p[0] / p[2] * fx, p[1] / p[2] * fx);  // projected to screen
-                fun(p_, cv::Scalar(0, 0, 255));
-            }
-
-            video_widget->update_image(frame_);
+            frames.put_free(buf);
+            continue;
         }
+
+        frames.put_ready(buf);
+    }
+}
+
+void pt_capture_thread::run()
+{
+    setPriority(QThread::HighPriority);
+    tracker.capture_frames();
+}
+
+void Tracker_PT::start_camera()
+{
+    if (camera)
+        camera->stop();
+    camera = nullptr;
+
+    camera_native = s.native_capture;
+
+#ifdef __linux
+    if (camera_native)
+    {
+        std::unique_ptr<V4L2Camera> cam(new V4L2Camera);
+        cam->set_device(s.camera_name);
+        cam->set_res(s.cam_res_x, s.cam_res_y);
+        cam->set_fps(s.cam_fps);
+        cam->start();
+        if (cam->is_open())
+            camera = std::move(cam);
+        else
+            qDebug() << "pt: no native capture, using opencv";
+    }
+#endif
+
+    if (!camera)
+    {
+        camera.reset(new CVCamera);
+        camera->set_device(s.camera_name);
+        camera->set_res(s.cam_res_x, s.cam_res_y);
+        camera->set_fps(s.cam_fps);
+        camera->start();
     }
-    qDebug()<<"Tracker:: Thread stopping";
 }
 
 void Tracker_PT::apply_settings()
@@ -177,8 +283,15 @@ void Tracker_PT::apply_settings()
     qDebug() << "Tracker:: Applying settings";
     QMutexLocker l(&camera_mtx);
 
-    CamInfo info = camera.get_desired();
-    const QString name = camera.get_desired_name();
+    if (!camera || camera_native != s.native_capture)
+    {
+        start_camera();
+        qDebug() << "Tracker::apply ends";
+        return;
+    }
+
+    CamInfo info = camera->get_desired();
+    const QString name = camera->get_desired_name();
 
     if (s.cam_fps != info.fps ||
         s.cam_res_x != info.res_x ||
@@ -186,12 +299,11 @@ void Tracker_PT::apply_settings()
         s.camera_name != name)
     {
         qDebug() << "pt: camera reset needed";
-        camera.stop();
-        camera.set_device(s.camera_name);
-        camera.set_res(s.cam_res_x, s.cam_res_y);
-        camera.set_fps(s.cam_fps);
-        frame = cv::Mat();
-        camera.start();
+        camera->stop();
+        camera->set_device(s.camera_name);
+        camera->set_res(s.cam_res_x, s.cam_res_y);
+        camera->set_fps(s.cam_fps);
+        camera->start();
     }
     else
         qDebug() << "pt: camera not needing reset";
@@ -216,49 +328,68 @@ void Tracker_PT::start_tracker(QFrame *parent_window)
 void Tracker_PT::data(double *data)
 {
     if (ever_success)
+        pose_to_data(pose(), data);
+}
+
+bool Tracker_PT::data_ex(double* data, sample_info& info)
+{
+    if (!ever_success)
+        return false;
+
+    Affine X_CM;
+
     {
-        Affine X_CM = pose();
+        QMutexLocker l(&data_mtx);
+        X_CM = published_X_CM;
+        info = published_sample;
+    }
 
-        Affine X_MH(mat33::eye(), vec3(s.t_MH_x, s.t_MH_y, s.t_MH_z));
-        Affine X_GH = X_CM * X_MH;
+    pose_to_data(X_CM, data);
 
-        // translate rotation matrix from opengl (G) to roll-pitch-yaw (E) frame
-        // -z -> x, y -> z, x -> -y
-        mat33 R_EG(0, 0,-1,
-                   -1, 0, 0,
-                   0, 1, 0);
-        mat33 R = R_EG *  X_GH.R * R_EG.t();
+    return true;
+}
 
-        using std::atan2;
-        using std::sqrt;
+void Tracker_PT::pose_to_data(const Affine& X_CM, double* data)
+{
+    Affine X_MH(mat33::eye(), vec3(s.t_MH_x, s.t_MH_y, s.t_MH_z));
+    Affine X_GH = X_CM * X_MH;
 
-        // extract rotation angles
-        {
-            f alpha, beta, gamma;
-            beta  = atan2( -R(2,0), sqrt(R(2,1)*R(2,1) + R(2,2)*R(2,2)) );
-            alpha = atan2( R(1,0), R(0,0));
-            gamma = atan2( R(2,1), R(2,2));
-
-            data[Yaw] = rad2deg * alpha;
-            data[Pitch] = -rad2deg * beta;
-            data[Roll] = rad2deg * gamma;
-        }
-        // get translation(s)
+    // translate rotation matrix from opengl (G) to roll-pitch-yaw (E) frame
+    // -z -> x, y -> z, x -> -y
+    mat33 R_EG(0, 0,-1,
+               -1, 0, 0,
+               0, 1, 0);
+    mat33 R = R_EG *  X_GH.R * R_EG.t();
 
-        const vec3& t = X_GH.t;
+    using std::atan2;
+    using std::sqrt;
 
-        // convert to cm
-        data[TX] = t[0] / 10;
-        data[TY] = t[1] / 10;
-        data[TZ] = t[2] / 10;
+    // extract rotation angles
+    {
+        f alpha, beta, gamma;
+        beta  = atan2( -R(2,0), sqrt(R(2,1)*R(2,1) + R(2,2)*R(2,2)) );
+        alpha = atan2( R(1,0), R(0,0));
+        gamma = atan2( R(2,1), R(2,2));
+
+        data[Yaw] = rad2deg * alpha;
+        data[Pitch] = -rad2deg * beta;
+        data[Roll] = rad2deg * gamma;
     }
+    // get translation(s)
+
+    const vec3& t = X_GH.t;
+
+    // convert to cm
+    data[TX] = t[0] / 10;
+    data[TY] = t[1] / 10;
+    data[TZ] = t[2] / 10;
 }
 
 Affine Tracker_PT::pose()
 {
     QMutexLocker l(&data_mtx);
 
-    return point_tracker.pose();
+    return published_X_CM;
 }
 
 int Tracker_PT::get_n_points()
@@ -270,7 +401,13 @@ bool Tracker_PT::get_cam_info(CamInfo* info)
 {
     QMutexLocker lock(&camera_mtx);
 
-    return camera.get_info(*info);
+    if (!camera || !camera->get_info(*info))
+        return false;
+
+    info->process_fps = process_fps;
+    info->dropped = frames.dropped();
+
+    return true;
 }
 
 #include "ftnoir_tracker_pt_dialog.h"
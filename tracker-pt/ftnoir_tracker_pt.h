@@ -14,6 +14,7 @@
 #include "camera.h"
 #include "point_extractor.h"
 #include "point_tracker.h"
+#include "frame-ring.hpp"
 #include "compat/timer.hpp"
 #include "cv/video-widget.hpp"
 #include "compat/pi-constant.hpp"
@@ -27,6 +28,16 @@
 #include <vector>
 
 class TrackerDialog_PT;
+class Tracker_PT;
+
+// grabs frames into the ring, so that processing time doesn't limit the frame rate
+class pt_capture_thread final : public QThread
+{
+    Tracker_PT& tracker;
+public:
+    pt_capture_thread(Tracker_PT& tracker) : tracker(tracker) {}
+    void run() override;
+};
 
 //-----------------------------------------------------------------------------
 // Constantly processes the tracking chain in a separate thread
@@ -37,11 +48,14 @@ class Tracker_PT : public QThread, public ITracker, private pt_types
     Q_OBJECT
     friend class camera_dialog;
     friend class TrackerDialog_PT;
+    friend class pt_capture_thread;
 public:
     Tracker_PT();
     ~Tracker_PT() override;
     void start_tracker(QFrame* parent_window) override;
     void data(double* data) override;
+    bool data_ex(double* data, sample_info& info) override;
+    bool is_event_driven() override { return true; }
 
     Affine pose();
     int  get_n_points();
@@ -59,11 +73,21 @@ private:
     void set_command(Command command);
     void reset_command(Command command);
 
-    bool get_focal_length(f& ret);
+    bool get_focal_length(f& ret, int w, int h);
+    void capture_frames();
+    void process_frame(cv::Mat& frame, double timestamp);
+    void pose_to_data(const Affine& X_CM, double* data);
+    void set_roi(f fx, int w, int h);
+    void start_camera();
 
     QMutex camera_mtx;
+    // guards the published pose and sample
     QMutex data_mtx;
-    CVCamera       camera;
+    Affine published_X_CM;
+    sample_info published_sample;
+    std::unique_ptr<Camera> camera;
+    // what the settings asked for, the camera may have fallen back
+    bool camera_native;
     PointExtractor point_extractor;
     PointTracker   point_tracker;
 
@@ -71,10 +95,16 @@ private:
     QFrame*      video_frame;
 
     settings_pt s;
-    Timer time;
-    cv::Mat frame;
+    Timer process_time;
+    frame_ring frames;
+    pt_capture_thread capture_thread;
+    double process_dt_mean;
     std::vector<vec2> points;
+    std::vector<f> point_sigma;
+    // where the points are expected in the next frame, empty when lost
+    cv::Rect roi;
 
+    std::atomic<int> process_fps;
     volatile unsigned point_count;
     volatile unsigned char commands;
     volatile bool ever_success;
@@ -53,6 +53,11 @@ TrackerDialog_PT::TrackerDialog_PT()
     tie_setting(s.m02_y, ui.m2y_spin);
     tie_setting(s.m02_z, ui.m2z_spin);
 
+    tie_setting(s.extra_point, ui.extra_point);
+    tie_setting(s.m03_x, ui.m3x_spin);
+    tie_setting(s.m03_y, ui.m3y_spin);
+    tie_setting(s.m03_z, ui.m3z_spin);
+
     tie_setting(s.t_MH_x, ui.tx_spin);
     tie_setting(s.t_MH_y, ui.ty_spin);
     tie_setting(s.t_MH_z, ui.tz_spin);
@@ -65,6 +70,12 @@ TrackerDialog_PT::TrackerDialog_PT()
     tie_setting(s.init_phase_timeout, ui.init_phase_timeout);
 
     tie_setting(s.auto_threshold, ui.auto_threshold);
+    tie_setting(s.native_capture, ui.native_capture);
+#ifndef __linux
+    ui.native_capture->setVisible(false);
+    ui.label_native_capture->setVisible(false);
+#endif
+    tie_setting(s.centroid_refine, ui.centroid_refine);
 
     connect( ui.tcalib_button,SIGNAL(toggled(bool)), this,SLOT(startstop_trans_calib(bool)) );
 
@@ -122,6 +133,7 @@ void TrackerDialog_PT::poll_tracker_info()
         {
             // display caminfo
             to_print = QString::number(info.res_x)+"x"+QString::number(info.res_y)+" @ "+QString::number(info.fps)+" FPS";
+            to_print += QStringLiteral(", processing %1 FPS, %2 dropped").arg(info.process_fps).arg(info.dropped);
         }
         ui.caminfo_label->setText(to_print);
 
@@ -43,6 +43,10 @@ struct settings_pt : opts
     value<int> m01_x, m01_y, m01_z;
     value<int> m02_x, m02_y, m02_z;
 
+    // optional fourth LED, for any of the models
+    value<bool> extra_point;
+    value<int> m03_x, m03_y, m03_z;
+
     value<int> t_MH_x, t_MH_y, t_MH_z;
 
     value<int> clip_ty, clip_tz, clip_by, clip_bz;
@@ -53,6 +57,8 @@ struct settings_pt : opts
     value<bool> dynamic_pose;
     value<int> init_phase_timeout;
     value<bool> auto_threshold;
+    value<bool> native_capture;
+    value<int> centroid_refine;
 
     settings_pt() :
         opts("tracker-pt"),
@@ -69,6 +75,10 @@ struct settings_pt : opts
         m02_x(b, "m_02-x", 0),
         m02_y(b, "m_02-y", 0),
         m02_z(b, "m_02-z", 0),
+        extra_point(b, "model-extra-point", false),
+        m03_x(b, "m_03-x", 0),
+        m03_y(b, "m_03-y", 0),
+        m03_z(b, "m_03-z", 0),
         t_MH_x(b, "model-centroid-x", 0),
         t_MH_y(b, "model-centroid-y", 0),
         t_MH_z(b, "model-centroid-z", 0),
@@ -83,6 +93,8 @@ struct settings_pt : opts
         fov(b, "camera-fov", 56),
         dynamic_pose(b, "dynamic-pose-resolution", true),
         init_phase_timeout(b, "init-phase-timeout", 500),
-        auto_threshold(b, "automatic-threshold", false)
+        auto_threshold(b, "automatic-threshold", false),
+        native_capture(b, "native-capture", false),
+        centroid_refine(b, "centroid-refinement", 0)
     {}
 };
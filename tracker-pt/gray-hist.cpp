@@ -0,0 +1,241 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "gray-hist.hpp"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#   define PT_GRAY_SSSE3
+#   define PT_TARGET_SSSE3 __attribute__((target("ssse3")))
+#   include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#   define PT_GRAY_SSSE3
+#   define PT_TARGET_SSSE3
+#   include <intrin.h>
+#   include <tmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define PT_GRAY_NEON
+#   include <arm_neon.h>
+#endif
+
+// same fixed-point weights and rounding as opencv's RGB2Gray<uchar>
+static constexpr int shift = 14;
+static constexpr int w0 = 4899, w1 = 9617, w2 = 1868;
+static constexpr int round_ = 1 << (shift - 1);
+
+using row_fn = void(*)(const unsigned char* src, unsigned char* dst, int n);
+
+static void gray_row_scalar(const unsigned char* src, unsigned char* dst, int n)
+{
+    for (int i = 0; i < n; i++, src += 3)
+        dst[i] = (unsigned char)((src[0] * w0 + src[1] * w1 + src[2] * w2 + round_) >> shift);
+}
+
+#if defined PT_GRAY_SSSE3
+
+static bool cpu_has_ssse3()
+{
+#   if defined _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#   else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#   endif
+}
+
+// pshufb masks picking channel k out of 16-byte chunk j of 16 packed pixels
+struct deinterleave_masks
+{
+    alignas(16) unsigned char m[3][3][16];
+
+    deinterleave_masks()
+    {
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                for (int i = 0; i < 16; i++)
+                {
+                    const int pos = 3 * i + k - 16 * j;
+                    m[k][j][i] = pos >= 0 && pos < 16 ? (unsigned char)pos : 0x80;
+                }
+    }
+};
+
+static const deinterleave_masks masks;
+
+PT_TARGET_SSSE3
+static __m128i channel(__m128i a, __m128i b, __m128i c, int k)
+{
+    const __m128i* m = reinterpret_cast<const __m128i*>(masks.m[k]);
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, _mm_load_si128(m + 0)),
+                                     _mm_shuffle_epi8(b, _mm_load_si128(m + 1))),
+                        _mm_shuffle_epi8(c, _mm_load_si128(m + 2)));
+}
+
+// four pixels' worth of 16-bit channels to 32-bit gray values
+PT_TARGET_SSSE3
+static __m128i weigh4(__m128i c0, __m128i c1, __m128i c2, __m128i w01, __m128i w2r, __m128i one)
+{
+    const __m128i s01 = _mm_madd_epi16(_mm_unpacklo_epi16(c0, c1), w01);
+    const __m128i s2r = _mm_madd_epi16(_mm_unpacklo_epi16(c2, one), w2r);
+    return _mm_srai_epi32(_mm_add_epi32(s01, s2r), shift);
+}
+
+PT_TARGET_SSSE3
+static void gray_row_ssse3(const unsigned char* src, unsigned char* dst, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i w01 = _mm_setr_epi16(w0, w1, w0, w1, w0, w1, w0, w1);
+    const __m128i w2r = _mm_setr_epi16(w2, round_, w2, round_, w2, round_, w2, round_);
+
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16, src += 48)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+
+        const __m128i c0 = channel(a, b, c, 0);
+        const __m128i c1 = channel(a, b, c, 1);
+        const __m128i c2 = channel(a, b, c, 2);
+
+        __m128i lo[3] = { _mm_unpacklo_epi8(c0, zero), _mm_unpacklo_epi8(c1, zero), _mm_unpacklo_epi8(c2, zero) };
+        __m128i hi[3] = { _mm_unpackhi_epi8(c0, zero), _mm_unpackhi_epi8(c1, zero), _mm_unpackhi_epi8(c2, zero) };
+
+        const __m128i g0 = weigh4(lo[0], lo[1], lo[2], w01, w2r, one);
+        const __m128i g1 = weigh4(_mm_srli_si128(lo[0], 8), _mm_srli_si128(lo[1], 8), _mm_srli_si128(lo[2], 8), w01, w2r, one);
+        const __m128i g2 = weigh4(hi[0], hi[1], hi[2], w01, w2r, one);
+        const __m128i g3 = weigh4(_mm_srli_si128(hi[0], 8), _mm_srli_si128(hi[1], 8), _mm_srli_si128(hi[2], 8), w01, w2r, one);
+
+        const __m128i g = _mm_packus_epi16(_mm_packs_epi32(g0, g1), _mm_packs_epi32(g2, g3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), g);
+    }
+
+    gray_row_scalar(src, dst + i, n - i);
+}
+
+#elif defined PT_GRAY_NEON
+
+static void gray_row_neon(const unsigned char* src, unsigned char* dst, int n)
+{
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16, src += 48)
+    {
+        const uint8x16x3_t px = vld3q_u8(src);
+
+        uint16x8_t c[2][3];
+        for (int k = 0; k < 3; k++)
+        {
+            c[0][k] = vmovl_u8(vget_low_u8(px.val[k]));
+            c[1][k] = vmovl_u8(vget_high_u8(px.val[k]));
+        }
+
+        uint16x4_t g[4];
+        for (int h = 0; h < 2; h++)
+        {
+            uint32x4_t lo = vdupq_n_u32(round_), hi = vdupq_n_u32(round_);
+            lo = vmlal_n_u16(lo, vget_low_u16(c[h][0]), w0);
+            lo = vmlal_n_u16(lo, vget_low_u16(c[h][1]), w1);
+            lo = vmlal_n_u16(lo, vget_low_u16(c[h][2]), w2);
+            hi = vmlal_n_u16(hi, vget_high_u16(c[h][0]), w0);
+            hi = vmlal_n_u16(hi, vget_high_u16(c[h][1]), w1);
+            hi = vmlal_n_u16(hi, vget_high_u16(c[h][2]), w2);
+            g[h * 2 + 0] = vshrn_n_u32(lo, shift);
+            g[h * 2 + 1] = vshrn_n_u32(hi, shift);
+        }
+
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(vcombine_u16(g[0], g[1])),
+                                      vmovn_u16(vcombine_u16(g[2], g[3]))));
+    }
+
+    gray_row_scalar(src, dst + i, n - i);
+}
+
+#endif
+
+namespace {
+
+struct kernel
+{
+    row_fn fn;
+    const char* name;
+
+    kernel() : fn(gray_row_scalar), name("scalar")
+    {
+#if defined PT_GRAY_SSSE3
+        if (cpu_has_ssse3())
+        {
+            fn = gray_row_ssse3;
+            name = "ssse3";
+        }
+#elif defined PT_GRAY_NEON
+        fn = gray_row_neon;
+        name = "neon";
+#endif
+    }
+};
+
+const kernel& get_kernel()
+{
+    static const kernel k;
+    return k;
+}
+
+} // ns
+
+const char* gray_hist_kernel_name()
+{
+    return get_kernel().name;
+}
+
+static void copy_row(const unsigned char* src, unsigned char* dst, int n)
+{
+    if (src != dst)
+        std::copy(src, src + n, dst);
+}
+
+void gray_hist(const cv::Mat& src, cv::Mat& dst, unsigned* hist)
+{
+    const row_fn fn = src.channels() == 1 ? copy_row : get_kernel().fn;
+    const int W = src.cols, H = src.rows;
+
+    // separate tables so repeated values don't stall on the same counter
+    unsigned tmp[4][256];
+
+    if (hist)
+        std::fill(&tmp[0][0], &tmp[0][0] + 4 * 256, 0u);
+
+    for (int y = 0; y < H; y++)
+    {
+        unsigned char* out = dst.ptr(y);
+
+        fn(src.ptr(y), out, W);
+
+        if (!hist)
+            continue;
+
+        int x = 0;
+        for (; x + 4 <= W; x += 4)
+        {
+            tmp[0][out[x + 0]]++;
+            tmp[1][out[x + 1]]++;
+            tmp[2][out[x + 2]]++;
+            tmp[3][out[x + 3]]++;
+        }
+        for (; x < W; x++)
+            tmp[0][out[x]]++;
+    }
+
+    if (hist)
+        for (int i = 0; i < 256; i++)
+            hist[i] = tmp[0][i] + tmp[1][i] + tmp[2][i] + tmp[3][i];
+}
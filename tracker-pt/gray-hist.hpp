@@ -0,0 +1,21 @@
+/* Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+// 3-channel to grayscale, bit-exact with cv::cvtColor(..., cv::COLOR_RGB2GRAY).
+// if hist isn't null, it receives a 256-bin histogram of the result,
+// summed up while each converted row is still in cache.
+// dst must already have src's size and CV_8U type, either may be a roi.
+// a src that's grayscale already gets copied, or if dst is the same
+// image, only the histogram gets done.
+void gray_hist(const cv::Mat& src, cv::Mat& dst, unsigned* hist);
+
+// which row kernel the cpu got, for benchmarks
+const char* gray_hist_kernel_name();
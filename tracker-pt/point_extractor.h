@@ -13,6 +13,8 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "ftnoir_tracker_pt_settings.h"
+#include "blob-labeller.hpp"
+#include "centroid-refine.hpp"
 #include "compat/pi-constant.hpp"
 
 #include <vector>
@@ -21,9 +23,11 @@ class PointExtractor final : private pt_types
 {
 public:
     // extracts points from frame and draws some processing info into frame, if draw_output is set
-    // dt: time since last call in seconds
+    // roi: only look for points within, in pixels. empty means the whole frame
+    // sigma: each point's standard error in the same units as the points,
+    // only estimated with sub-pixel refinement on, zero otherwise
     // WARNING: returned reference is valid as long as object
-    void extract_points(cv::Mat &frame, std::vector<vec2>& points);
+    void extract_points(cv::Mat &frame, std::vector<vec2>& points, std::vector<f>& sigma, const cv::Rect& roi = cv::Rect());
     PointExtractor();
 
     settings_pt s;
@@ -32,15 +36,15 @@ private:
     static constexpr int max_blobs = 16;
 
     cv::Mat frame_gray;
-    cv::Mat frame_bin;
-    cv::Mat hist;
-    cv::Mat frame_blobs;
+    unsigned hist[256];
+    blob_labeller labeller;
 
     struct blob
     {
-        double radius, brightness;
+        double radius, brightness, sigma;
         vec2 pos;
-        blob(double radius, const cv::Vec2d& pos, double brightness) : radius(radius), brightness(brightness), pos(pos)
+        blob(double radius, const cv::Vec2d& pos, double brightness, double sigma) :
+            radius(radius), brightness(brightness), sigma(sigma), pos(pos)
         {
             //qDebug() << "radius" << radius << "pos" << pos[0] << pos[1];
         }
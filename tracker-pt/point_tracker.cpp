@@ -18,6 +18,7 @@ using mat33 = pt_types::mat33;
 using vec3 = pt_types::vec3;
 using f = pt_types::f;
 constexpr unsigned PointModel::N_POINTS;
+constexpr unsigned PointModel::max_points;
 
 static void get_row(const mat33& m, int i, vec3& v)
 {
@@ -38,9 +39,54 @@ static bool d_vals_sort(const std::pair<f,int> a, const std::pair<f,int> b)
     return a.first < b.first;
 }
 
+static mat33 rodrigues(const vec3& w)
+{
+    const f theta = std::sqrt(w.dot(w));
+    if (!(theta > f(1e-12)))
+        return mat33::eye();
+    const vec3 k = w * (1/theta);
+    const mat33 K(0, -k[2], k[1],
+                  k[2], 0, -k[0],
+                  -k[1], k[0], 0);
+    return mat33::eye() + std::sin(theta) * K + (1 - std::cos(theta)) * (K * K);
+}
+
+// keeps repeated small updates from drifting away from a rotation
+static void orthonormalize(mat33& R)
+{
+    vec3 a, b;
+    get_row(R, 0, a);
+    get_row(R, 1, b);
+    a *= 1/cv::norm(a);
+    b -= a.dot(b) * a;
+    b *= 1/cv::norm(b);
+    set_row(R, 0, a);
+    set_row(R, 1, b);
+    set_row(R, 2, a.cross(b));
+}
+
+static pt_types::vec2 project(const Affine& X, const vec3& v_M, f focal_length)
+{
+    const vec3 v_C = X * v_M;
+    return pt_types::vec2(focal_length*v_C[0]/v_C[2], focal_length*v_C[1]/v_C[2]);
+}
+
 PointModel::PointModel(settings_pt& s)
 {
     set_model(s);
+    set_basis();
+}
+
+PointModel::PointModel(const vec3& M01, const vec3& M02) : M01(M01), M02(M02), n_points(3)
+{
+    points[0] = vec3(0, 0, 0);
+    points[1] = M01;
+    points[2] = M02;
+    set_basis();
+}
+
+void PointModel::set_basis()
+{
     // calculate u
     u = M01.cross(M02);
     u /= norm(u);
@@ -52,6 +98,13 @@ PointModel::PointModel(settings_pt& s)
     P = 1/(s11*s22-s12*s12) * mat22(s22, -s12, -s12,  s11);
 }
 
+bool PointModel::degenerate() const
+{
+    // nearly collinear, no plane to speak of
+    const f s11 = M01.dot(M01), s12 = M01.dot(M02), s22 = M02.dot(M02);
+    return !(s11*s22 - s12*s12 > f(1e-4) * s11*s22);
+}
+
 void PointModel::set_model(settings_pt& s)
 {
     switch (s.active_model_panel)
@@ -69,6 +122,14 @@ void PointModel::set_model(settings_pt& s)
         M02 = vec3(s.m02_x, s.m02_y, s.m02_z);
         break;
     }
+
+    points[0] = vec3(0, 0, 0);
+    points[1] = M01;
+    points[2] = M02;
+    n_points = 3;
+
+    if (s.extra_point)
+        points[n_points++] = vec3(s.m03_x, s.m03_y, s.m03_z);
 }
 
 void PointModel::get_d_order(const std::vector<vec2>& points, int* d_order, vec2 d) const
@@ -89,62 +150,148 @@ void PointModel::get_d_order(const std::vector<vec2>& points, int* d_order, vec2
 }
 
 
-PointTracker::PointTracker() : init_phase(true)
+PointTracker::PointTracker() : init_phase(true), last_iters(0)
 {
 }
 
-PointTracker::PointOrder PointTracker::find_correspondences_previous(const std::vector<vec2>& points,
-                                                                     const PointModel& model,
-                                                                     f focal_length,
-                                                                     int w,
-                                                                     int h)
+bool PointTracker::find_correspondences_previous(const std::vector<vec2>& points,
+                                                 const std::vector<f>& weights,
+                                                 const PointModel& model,
+                                                 const Affine& X,
+                                                 f focal_length,
+                                                 f max_dist,
+                                                 PointOrder& ret)
 {
-    PointTracker::PointOrder p;
-    p.points[0] = project(vec3(0,0,0), focal_length);
-    p.points[1] = project(model.M01, focal_length);
-    p.points[2] = project(model.M02, focal_length);
+    ret = PointOrder();
 
-    const int diagonal = int(std::sqrt(w*w + h*h));
-    static constexpr int div = 100;
-    const int max_dist = diagonal / div; // 8 pixels for 640x480
+    vec2 projected[PointModel::max_points];
+    for (unsigned i = 0; i < model.n_points; i++)
+        projected[i] = ::project(X, model.points[i], focal_length);
 
-    // set correspondences by minimum distance to projected model point
-    bool point_taken[PointModel::N_POINTS];
-    for (unsigned i=0; i<PointModel::N_POINTS; ++i)
-        point_taken[i] = false;
+    // every model point and point pair close enough, taken closest first.
+    // stray points can't take a model point away from the right one.
+    struct candidate { f sdist; unsigned model_idx, point_idx; };
+    candidate pairs[PointModel::max_points * 16];
+    unsigned npairs = 0;
 
-    for (unsigned i=0; i<PointModel::N_POINTS; ++i)
-    {
-        f min_sdist = 0;
-        unsigned min_idx = 0;
-        // find closest point to projected model point i
-        for (unsigned j=0; j<PointModel::N_POINTS; ++j)
+    const unsigned npoints = std::min(unsigned(points.size()), 16u);
+    const f max_sdist = max_dist * max_dist;
+
+    for (unsigned i = 0; i < model.n_points; i++)
+        for (unsigned j = 0; j < npoints; j++)
         {
-            vec2 d = p.points[i]-points[j];
-            f sdist = d.dot(d);
-            if (sdist < min_sdist || j==0)
-            {
-                min_idx = j;
-                min_sdist = sdist;
-            }
+            const vec2 d = projected[i] - points[j];
+            const f sdist = d.dot(d);
+            if (sdist <= max_sdist)
+                pairs[npairs++] = candidate { sdist, i, j };
         }
-        if (min_sdist > max_dist)
-            return find_correspondences(points, model);
 
-        // if one point is closest to more than one model point, fallback
-        if (point_taken[min_idx])
+    std::sort(pairs, pairs + npairs, [](const candidate& a, const candidate& b) { return a.sdist < b.sdist; });
+
+    bool point_taken[16] = {};
+
+    for (unsigned k = 0; k < npairs; k++)
+    {
+        const candidate& p = pairs[k];
+        if (ret.found[p.model_idx] || point_taken[p.point_idx])
+            continue;
+        point_taken[p.point_idx] = true;
+        ret.found[p.model_idx] = true;
+        ret.points[p.model_idx] = points[p.point_idx];
+        ret.weights[p.model_idx] = weights[p.point_idx];
+        ret.count++;
+    }
+
+    return ret.count >= PointModel::N_POINTS;
+}
+
+bool PointTracker::find_correspondences_consensus(const std::vector<vec2>& points,
+                                                  const std::vector<f>& weights,
+                                                  const PointModel& model,
+                                                  const Affine* guess,
+                                                  f focal_length,
+                                                  f max_dist,
+                                                  PointOrder& order,
+                                                  Affine& X)
+{
+    // the extractor puts its best points first, stray reflections
+    // usually come after the LEDs
+    static constexpr unsigned max_candidates = 6;
+    const unsigned n = std::min(unsigned(points.size()), max_candidates);
+
+    unsigned best_count = 0;
+    f best_err = 0;
+    int iters = 0;
+    // every model point has a point, nothing left to agree on
+    bool done = false;
+
+    std::vector<vec2> triple(PointModel::N_POINTS);
+
+    // hypothesize a pose from each three points and three model points,
+    // keep the one that the most other points agree with
+    for (unsigned a = 0; !done && a < model.n_points; a++)
+    for (unsigned b = a + 1; !done && b < model.n_points; b++)
+    for (unsigned c = b + 1; !done && c < model.n_points; c++)
+    {
+        const vec3& M0 = model.points[a];
+        const PointModel sub(model.points[b] - M0, model.points[c] - M0);
+
+        if (sub.degenerate())
+            continue;
+
+        Affine sub_guess;
+        if (guess)
+            sub_guess = Affine(guess->R, guess->R * M0 + guess->t);
+
+        for (unsigned i = 0; !done && i < n; i++)
+        for (unsigned j = i + 1; !done && j < n; j++)
+        for (unsigned k = j + 1; !done && k < n; k++)
         {
-            init_phase = true;
-            return find_correspondences(points, model);
+            triple[0] = points[i]; triple[1] = points[j]; triple[2] = points[k];
+
+            const PointOrder sub_order = find_correspondences(triple, sub);
+            Affine X_sub;
+            const int ret = POSIT(sub, sub_order.points, focal_length, guess ? &sub_guess : nullptr, X_sub);
+
+            if (ret < 0)
+                continue;
+
+            iters += ret;
+
+            const Affine X_full(X_sub.R, X_sub.t - X_sub.R * M0);
+
+            if (!(X_full.t[2] > 0))
+                continue;
+
+            PointOrder o;
+            if (!find_correspondences_previous(points, weights, model, X_full, focal_length, max_dist, o))
+                continue;
+
+            f err = 0;
+            for (unsigned m = 0; m < model.n_points; m++)
+                if (o.found[m])
+                {
+                    const vec2 d = ::project(X_full, model.points[m], focal_length) - o.points[m];
+                    err += d.dot(d);
+                }
+
+            if (o.count > best_count || (o.count == best_count && err < best_err))
+            {
+                best_count = o.count;
+                best_err = err;
+                order = o;
+                X = X_full;
+                done = best_count == model.n_points;
+            }
         }
-        point_taken[min_idx] = true;
-        p.points[i] = points[min_idx];
     }
 
-    return p;
+    last_iters = iters;
+    return best_count >= PointModel::N_POINTS;
 }
 
-void PointTracker::track(const std::vector<vec2>& points,
+bool PointTracker::track(const std::vector<vec2>& points,
+                         const std::vector<f>& sigma,
                          const PointModel& model,
                          f focal_length,
                          bool dynamic_pose,
@@ -152,24 +299,69 @@ void PointTracker::track(const std::vector<vec2>& points,
                          int w,
                          int h)
 {
-    PointOrder order;
-
     if (t.elapsed_ms() > init_phase_timeout)
     {
         t.start();
         init_phase = true;
     }
 
-    if (!dynamic_pose || init_phase)
-        order = find_correspondences(points, model);
-    else
+    const f diagonal = std::sqrt(f(w*w + h*h));
+    // where points may be from where the last pose puts them, same as the roi's margin
+    const f max_motion = diagonal / 16 / w;
+    // where points must be from where a hypothesized pose puts them
+    static constexpr int div = 100;
+    const f max_dist = diagonal / div / w; // 8 pixels for 640x480
+
+    // weighted by the inverse variance. the floor stands for what the
+    // extractor can't see, like the model's own dimensions being off.
+    const f sigma_floor = f(.5) / w;
+    weights.resize(points.size());
+    for (unsigned i = 0; i < points.size(); i++)
     {
-        order = find_correspondences_previous(points, model, focal_length, w, h);
+        const f s = i < sigma.size() ? sigma[i] : f(0);
+        weights[i] = 1 / (s*s + sigma_floor*sigma_floor);
     }
 
-    POSIT(model, order, focal_length);
-    init_phase = false;
-    t.start();
+    const bool warm = dynamic_pose && !init_phase && X_CM.t[2] > 0;
+    const Affine* guess = warm ? &X_CM : nullptr;
+
+    PointOrder order;
+    Affine X = X_CM;
+    bool ok = false;
+
+    // the last pose is nearly right, match the points near where it puts
+    // them and solve from there
+    if (warm && find_correspondences_previous(points, weights, model, X_CM, focal_length, max_motion, order))
+    {
+        if (order.count == PointModel::N_POINTS && order.found[0] && order.found[1] && order.found[2])
+            last_iters = POSIT(model, order.points, focal_length, guess, X);
+        else
+            last_iters = refine(model, order, focal_length, X);
+
+        ok = last_iters >= 0 && max_residual(model, order, X, focal_length) <= max_dist;
+    }
+
+    if (!ok && find_correspondences_consensus(points, weights, model, guess, focal_length, max_dist, order, X))
+    {
+        ok = true;
+        if (order.count > PointModel::N_POINTS)
+        {
+            const int iters = refine(model, order, focal_length, X);
+            if (iters >= 0)
+                last_iters += iters;
+            else
+                ok = false;
+        }
+    }
+
+    if (ok)
+    {
+        X_CM = X;
+        init_phase = false;
+        t.start();
+    }
+
+    return ok;
 }
 
 PointTracker::PointOrder PointTracker::find_correspondences(const std::vector<vec2>& points, const PointModel& model)
@@ -196,7 +388,88 @@ PointTracker::PointOrder PointTracker::find_correspondences(const std::vector<ve
     return p;
 }
 
-int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f focal_length)
+int PointTracker::refine(const PointModel& model, const PointOrder& order, f focal_length, Affine& X)
+{
+    using mat66 = mat<6, 6>;
+    using vec6 = vec<6>;
+
+    static constexpr int max_iter = 10;
+
+    int i = 0;
+    while (i < max_iter)
+    {
+        mat66 H = mat66::zeros();
+        vec6 g = vec6::all(0);
+
+        for (unsigned k = 0; k < model.n_points; k++)
+        {
+            if (!order.found[k])
+                continue;
+
+            const vec3 q = X.R * model.points[k];
+            const vec3 c = q + X.t;
+
+            if (!(c[2] > 0))
+                return -1;
+
+            const f iz = 1/c[2];
+            const vec2 r = order.points[k] - vec2(focal_length*c[0]*iz, focal_length*c[1]*iz);
+
+            // derivatives of the projection wrt. the point in camera space,
+            // which moves by omega x q for a small rotation and by dt
+            const vec3 du(focal_length*iz, 0, -focal_length*c[0]*iz*iz);
+            const vec3 dv(0, focal_length*iz, -focal_length*c[1]*iz*iz);
+
+            for (int row = 0; row < 2; row++)
+            {
+                const vec3& d = row == 0 ? du : dv;
+                const vec3 d_omega = q.cross(d);
+                const vec6 J(d_omega[0], d_omega[1], d_omega[2], d[0], d[1], d[2]);
+                const f wr = order.weights[k] * r[row];
+
+                for (int a = 0; a < 6; a++)
+                {
+                    g[a] += J[a] * wr;
+                    for (int b = 0; b < 6; b++)
+                        H(a, b) += order.weights[k] * J[a] * J[b];
+                }
+            }
+        }
+
+        const vec6 delta = H.solve(g, cv::DECOMP_LU);
+        const vec3 omega(delta[0], delta[1], delta[2]);
+        const vec3 dt(delta[3], delta[4], delta[5]);
+
+        for (int k = 0; k < 6; k++)
+            if (nanp(delta[k]))
+            {
+                qDebug() << "pose refine nan";
+                return -1;
+            }
+
+        X.R = rodrigues(omega) * X.R;
+        X.t += dt;
+        i++;
+
+        if (cv::norm(omega) < f(1e-6) && cv::norm(dt) < f(1e-6) * cv::norm(X.t))
+            break;
+    }
+
+    orthonormalize(X.R);
+
+    return i;
+}
+
+PointTracker::f PointTracker::max_residual(const PointModel& model, const PointOrder& order, const Affine& X, f focal_length)
+{
+    f ret = 0;
+    for (unsigned k = 0; k < model.n_points; k++)
+        if (order.found[k])
+            ret = std::max(ret, f(cv::norm(::project(X, model.points[k], focal_length) - order.points[k])));
+    return ret;
+}
+
+int PointTracker::POSIT(const PointModel& model, const vec2* order, f focal_length, const Affine* guess, Affine& X)
 {
     // POSIT algorithm for coplanar points as presented in
     // [Denis Oberkampf, Daniel F. DeMenthon, Larry S. Davis: "Iterative Pose Estimation Using Coplanar Feature Points"]
@@ -205,11 +478,17 @@ int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f foc
     // The expected rotation used for resolving the ambiguity in POSIT:
     // In every iteration step the rotation closer to R_expected is taken
     mat33 R_expected = mat33::eye();
+    f Z0 = f(1000);
 
     // initial pose = last (predicted) pose
+    if (guess)
+    {
+        R_expected = guess->R;
+        Z0 = guess->t[2];
+    }
+
     vec3 k;
     get_row(R_expected, 2, k);
-    f Z0 = f(1000);
 
     f old_epsilon_1 = 0;
     f old_epsilon_2 = 0;
@@ -225,8 +504,6 @@ int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f foc
 
     static constexpr int max_iter = 100;
 
-    const vec2* order = order_.points;
-
     using std::sqrt;
     using std::atan;
     using std::cos;
@@ -306,10 +583,12 @@ int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f foc
 
         get_row(*R_current, 2, k);
 
-        // check for convergence condition
+        // check for convergence condition. the depth ratios settle well
+        // below a micron at this point, a warm start gets here in a few steps
+        static constexpr f tol = f(1e-6);
         const f delta = fabs(epsilon_1 - old_epsilon_1) + fabs(epsilon_2 - old_epsilon_2);
 
-        if (!(delta > eps))
+        if (!(delta > tol))
             break;
 
         old_epsilon_1 = epsilon_1;
@@ -339,10 +618,10 @@ int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f foc
         }
 
     // apply results
-    X_CM.R = r;
-    X_CM.t[0] = t[0];
-    X_CM.t[1] = t[1];
-    X_CM.t[2] = t[2];
+    X.R = r;
+    X.t[0] = t[0];
+    X.t[1] = t[1];
+    X.t[2] = t[2];
 
     //qDebug() << "iter:" << i;
 
@@ -351,6 +630,5 @@ int PointTracker::POSIT(const PointModel& model, const PointOrder& order_, f foc
 
 pt_types::vec2 PointTracker::project(const vec3& v_M, f focal_length)
 {
-    vec3 v_C = X_CM * v_M;
-    return vec2(focal_length*v_C[0]/v_C[2], focal_length*v_C[1]/v_C[2]);
+    return ::project(X_CM, v_M, focal_length);
 }
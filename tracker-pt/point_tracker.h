@@ -46,14 +46,16 @@ inline pt_types::vec3 operator*(const Affine& X, const pt_types::vec3& v)
 }
 
 // ----------------------------------------------------------------------------
-// Describes a 3-point model
+// Describes a 3-point model, optionally with a fourth point
 // nomenclature as in
 // [Denis Oberkampf, Daniel F. DeMenthon, Larry S. Davis: "Iterative Pose Estimation Using Coplanar Feature Points"]
 class PointModel final : private pt_types
 {
     friend class PointTracker;
 public:
+    // points needed for a pose, POSIT works on three at a time
     static constexpr unsigned N_POINTS = 3;
+    static constexpr unsigned max_points = 4;
 
     vec3 M01;      // M01 in model frame
     vec3 M02;      // M02 in model frame
@@ -62,48 +64,87 @@ public:
 
     mat22 P;
 
+    // the reference point at the origin, M01, M02, then the extra point
+    vec3 points[max_points];
+    unsigned n_points;
+
     enum Model { Clip, Cap, Custom };
 
     PointModel(settings_pt& s);
     void set_model(settings_pt& s);
     void get_d_order(const std::vector<vec2>& points, int* d_order, vec2 d) const;
+
+private:
+    // three of the model's points, shifted so that the first is at the origin
+    PointModel(const vec3& M01, const vec3& M02);
+    void set_basis();
+    bool degenerate() const;
 };
 
 // ----------------------------------------------------------------------------
 // Tracks a 3-point model
 // implementing the POSIT algorithm for coplanar points as presented in
 // [Denis Oberkampf, Daniel F. DeMenthon, Larry S. Davis: "Iterative Pose Estimation Using Coplanar Feature Points"]
+// with more points or stray blobs, correspondences come from the points
+// that agree on a pose and the pose is refined over all of them.
 class PointTracker final : private pt_types
 {
 public:
     PointTracker();
     // track the pose using the set of normalized point coordinates (x pos in range -0.5:0.5)
+    // sigma : each point's standard error in the same units, or zero if not known
     // f : (focal length)/(sensor width)
     // dt : time since last call
-    void track(const std::vector<vec2>& projected_points, const PointModel& model, f focal_length, bool dynamic_pose, int init_phase_timeout, int w, int h);
+    // returns false and leaves the pose alone if the points don't fit the model
+    bool track(const std::vector<vec2>& projected_points, const std::vector<f>& sigma,
+               const PointModel& model, f focal_length, bool dynamic_pose, int init_phase_timeout, int w, int h);
     Affine pose() { return X_CM; }
     vec2 project(const vec3& v_M, PointTracker::f focal_length);
+    // solver iterations on the last frame, for diagnostics
+    int iterations() const { return last_iters; }
 
 private:
-    // the points in model order
+    // the points in model order, for the model points that have one
     struct PointOrder
     {
-        vec2 points[PointModel::N_POINTS];
-        PointOrder()
+        vec2 points[PointModel::max_points];
+        f weights[PointModel::max_points];
+        bool found[PointModel::max_points];
+        unsigned count;
+        PointOrder() : count(0)
         {
-            for (unsigned i = 0; i < PointModel::N_POINTS; i++)
+            for (unsigned i = 0; i < PointModel::max_points; i++)
+            {
                 points[i] = vec2(0, 0);
+                weights[i] = 1;
+                found[i] = false;
+            }
         }
     };
 
     PointOrder find_correspondences(const std::vector<vec2>& projected_points, const PointModel &model);
-    PointOrder find_correspondences_previous(const std::vector<vec2>& points, const PointModel &model, f focal_length, int w, int h);
-    int POSIT(const PointModel& point_model, const PointOrder& order, f focal_length);  // The POSIT algorithm, returns the number of iterations
+    // nearest points to where X projects the model, within max_dist
+    bool find_correspondences_previous(const std::vector<vec2>& points, const std::vector<f>& weights,
+                                       const PointModel &model, const Affine& X, f focal_length, f max_dist,
+                                       PointOrder& ret);
+    // the pose most points agree with, from poses for each three of them
+    bool find_correspondences_consensus(const std::vector<vec2>& points, const std::vector<f>& weights,
+                                        const PointModel& model, const Affine* guess, f focal_length, f max_dist,
+                                        PointOrder& order, Affine& X);
+    // The POSIT algorithm, returns the number of iterations, or -1 on failure
+    // guess : pose to start from and to resolve the ambiguity with, or null
+    int POSIT(const PointModel& point_model, const vec2* order, f focal_length, const Affine* guess, Affine& X);
+    // gauss-newton on the weighted reprojection error, starting from X
+    int refine(const PointModel& model, const PointOrder& order, f focal_length, Affine& X);
+    static f max_residual(const PointModel& model, const PointOrder& order, const Affine& X, f focal_length);
 
     Affine X_CM; // trafo from model to camera
 
+    std::vector<f> weights;
+
     Timer t;
     bool init_phase;
+    int last_iters;
 };
 
 #endif //POINTTRACKER_H